@@ -0,0 +1,130 @@
+#include "CollisionGuard.h"
+
+#include <math.h>
+#include <string.h>
+
+static const CollisionZones defaultZones = { COLLISION_STOP_MM, COLLISION_SLOW_MM, COLLISION_CONE_DEG };
+
+static inline uint16_t vehicleAngle(uint8_t sensor, uint16_t bin) {
+    uint16_t a = (uint16_t)(bin + (sensor ? 180u : 0u));
+    return (a >= COLLISION_BINS) ? (uint16_t)(a - COLLISION_BINS) : a;
+}
+
+CollisionGuard::CollisionGuard() : zones(defaultZones), isMoving(false), travel(0) {
+    memset(&lastHit, 0, sizeof(lastHit));
+    memset(binsInZone, 0, sizeof(binsInZone));
+    memset(lastMm, 0, sizeof(lastMm));
+    memset(binLevel, 0, sizeof(binLevel));
+    memset(lastChunkMs, 0, sizeof(lastChunkMs));
+    memset(live, 0, sizeof(live));
+    binsInZone[COLLISION_CLEAR] = COLLISION_SENSORS * COLLISION_BINS;
+    rebuildLimits();
+}
+
+void CollisionGuard::setZones(const CollisionZones& _zones) {
+    zones = _zones;
+    if (zones.coneDeg > 180u) zones.coneDeg = 180u;
+    rebuildLimits();
+    reclassify();
+}
+
+void CollisionGuard::setHeading(uint8_t x, uint8_t y) {
+    int dx = (int)x - COLLISION_JOY_CENTRE;
+    int dy = (int)y - COLLISION_JOY_CENTRE;
+    bool nowMoving = dx > COLLISION_JOY_DEADBAND || dx < -COLLISION_JOY_DEADBAND ||
+                     dy > COLLISION_JOY_DEADBAND || dy < -COLLISION_JOY_DEADBAND;
+    uint16_t deg = 0;
+    if (nowMoving) {
+        int d = (int)lroundf(atan2f((float)dx, (float)dy) * (180.0f / (float)M_PI));
+        deg = (uint16_t)((d + 360) % 360);
+    }
+    if (nowMoving == isMoving && deg == travel) return;
+
+    isMoving = nowMoving;
+    travel = deg;
+    rebuildLimits();
+    reclassify();
+}
+
+void CollisionGuard::rebuildLimits() {
+    for (uint16_t a = 0; a < COLLISION_BINS; a++) {
+        int diff = (int)a - (int)travel;
+        if (diff < 0) diff = -diff;
+        if (diff > 180) diff = 360 - diff;
+        stopBelow[a] = zones.stopMm;
+        slowBelow[a] = (isMoving && diff <= (int)zones.coneDeg) ? zones.slowMm : 0u;
+    }
+}
+
+uint8_t CollisionGuard::classify(uint16_t vehicleDeg, uint16_t mm) const {
+    if (mm == 0u) return COLLISION_CLEAR;
+    if (mm < stopBelow[vehicleDeg]) return COLLISION_STOP;
+    if (mm < slowBelow[vehicleDeg]) return COLLISION_SLOW;
+    return COLLISION_CLEAR;
+}
+
+// Only after a heading or zone change: every remembered reading against the
+// new limits.
+void CollisionGuard::reclassify() {
+    memset(binsInZone, 0, sizeof(binsInZone));
+    for (uint8_t s = 0; s < COLLISION_SENSORS; s++) {
+        for (uint16_t b = 0; b < COLLISION_BINS; b++) {
+            uint8_t lvl = classify(vehicleAngle(s, b), lastMm[s][b]);
+            binLevel[s][b] = lvl;
+            binsInZone[lvl]++;
+        }
+    }
+}
+
+void CollisionGuard::clearSensor(uint8_t sensor) {
+    for (uint16_t b = 0; b < COLLISION_BINS; b++) {
+        binsInZone[binLevel[sensor][b]]--;
+        binsInZone[COLLISION_CLEAR]++;
+        binLevel[sensor][b] = COLLISION_CLEAR;
+        lastMm[sensor][b] = 0u;
+    }
+    live[sensor] = false;
+}
+
+uint8_t CollisionGuard::addChunk(uint8_t sensor, const ScanChunk& chunk, uint32_t nowMs) {
+    if (sensor >= COLLISION_SENSORS || chunk.distances == nullptr || chunk.deltaTheta == 0u) return level();
+
+    CollisionHit hit = { COLLISION_CLEAR, sensor, 0u, 0xFFFFu };
+    uint16_t bin = chunk.startTheta % COLLISION_BINS;
+    for (uint8_t i = 0; i < chunk.count; i++) {
+        uint16_t mm = (uint16_t)(chunk.distances[2u * i] | (chunk.distances[2u * i + 1u] << 8));
+        uint16_t deg = vehicleAngle(sensor, bin);
+        uint8_t lvl = classify(deg, mm);
+
+        binsInZone[binLevel[sensor][bin]]--;
+        binsInZone[lvl]++;
+        binLevel[sensor][bin] = lvl;
+        lastMm[sensor][bin] = mm;
+
+        if (lvl != COLLISION_CLEAR && (lvl > hit.level || (lvl == hit.level && mm < hit.distanceMm))) {
+            hit.level = lvl;
+            hit.angleDeg = deg;
+            hit.distanceMm = mm;
+        }
+        bin = (uint16_t)(bin + chunk.deltaTheta);
+        if (bin >= COLLISION_BINS) bin = (uint16_t)(bin - COLLISION_BINS);
+    }
+    if (hit.level != COLLISION_CLEAR) lastHit = hit;
+
+    lastChunkMs[sensor] = nowMs;
+    live[sensor] = true;
+    return level();
+}
+
+uint8_t CollisionGuard::poll(uint32_t nowMs) {
+    for (uint8_t s = 0; s < COLLISION_SENSORS; s++) {
+        if (live[s] && (nowMs - lastChunkMs[s]) >= COLLISION_STALE_MS) clearSensor(s);
+    }
+    return level();
+}
+
+uint8_t CollisionGuard::level() const {
+    if (binsInZone[COLLISION_STOP] > 0u) return COLLISION_STOP;
+    if (binsInZone[COLLISION_SLOW] > 0u) return COLLISION_SLOW;
+    return COLLISION_CLEAR;
+}
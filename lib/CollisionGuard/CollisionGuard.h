@@ -0,0 +1,85 @@
+#ifndef COLLISION_GUARD_H
+#define COLLISION_GUARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ScanAssembler.h"
+
+#define COLLISION_SENSORS 2          // sensor 1 faces backwards
+#define COLLISION_BINS 360
+#define COLLISION_STOP_MM 300u       // default zones
+#define COLLISION_SLOW_MM 700u
+#define COLLISION_CONE_DEG 60u       // half-width of the slow zone around the direction of travel
+#define COLLISION_STALE_MS 500u      // forget a sensor that has sent nothing this long
+#define COLLISION_JOY_CENTRE 128     // STATUS_RESPONSE x/y at rest
+#define COLLISION_JOY_DEADBAND 12
+
+enum CollisionLevel {
+    COLLISION_CLEAR = 0,
+    COLLISION_SLOW,
+    COLLISION_STOP,
+    COLLISION_LEVELS
+};
+
+struct CollisionZones {
+    uint16_t stopMm;    // anything closer, in any direction
+    uint16_t slowMm;    // anything closer within coneDeg of the direction of travel
+    uint16_t coneDeg;
+};
+
+// The closest return in a zone from the chunk that last had one. Angles are
+// vehicle-relative: 0 straight ahead, clockwise.
+struct CollisionHit {
+    uint8_t level;
+    uint8_t sensor;
+    uint16_t angleDeg;
+    uint16_t distanceMm;
+};
+
+// Zone check on every LiDAR chunk as it arrives, ahead of scan assembly.
+// Each bin keeps the zone its latest reading fell in, with a count per zone,
+// so a chunk costs a table lookup per sample and the overall level is known
+// without waiting for the sweep to finish.
+//
+// The slow zone follows the direction of travel from the STATUS_RESPONSE
+// joystick x/y; at rest (or before any status) only the stop zone applies.
+class CollisionGuard {
+public:
+    CollisionGuard();
+
+    void setZones(const CollisionZones& zones);
+    void setHeading(uint8_t x, uint8_t y);
+
+    // Returns the overall level after the chunk.
+    uint8_t addChunk(uint8_t sensor, const ScanChunk& chunk, uint32_t nowMs);
+    // Drops sensors that have gone quiet. Returns the overall level.
+    uint8_t poll(uint32_t nowMs);
+
+    uint8_t level() const;
+    bool moving() const { return isMoving; }
+    uint16_t travelDeg() const { return travel; }
+
+    CollisionHit lastHit;
+    uint16_t binsInZone[COLLISION_LEVELS];
+
+private:
+    CollisionZones zones;
+    bool isMoving;
+    uint16_t travel;
+
+    // Per vehicle angle: readings below these are in the zone (0 = never).
+    uint16_t stopBelow[COLLISION_BINS];
+    uint16_t slowBelow[COLLISION_BINS];
+
+    uint16_t lastMm[COLLISION_SENSORS][COLLISION_BINS];
+    uint8_t binLevel[COLLISION_SENSORS][COLLISION_BINS];
+    uint32_t lastChunkMs[COLLISION_SENSORS];
+    bool live[COLLISION_SENSORS];
+
+    void rebuildLimits();
+    void reclassify();
+    void clearSensor(uint8_t sensor);
+    uint8_t classify(uint16_t vehicleDeg, uint16_t mm) const;
+};
+
+#endif
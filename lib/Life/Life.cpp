@@ -0,0 +1,134 @@
+#include "Life.h"
+
+#include <string.h>
+
+#define LIFE_LAST (LIFE_WORDS - 1)
+#define LIFE_TAIL (LIFE_COLS - 64 * LIFE_LAST)   // cells in the last word
+#define LIFE_TAIL_MASK ((LIFE_TAIL == 64) ? ~0ull : ((1ull << LIFE_TAIL) - 1u))
+
+// Each cell takes its west neighbour's state (column - 1, wrapping).
+static inline void shiftWest(const uint64_t* row, uint64_t* out) {
+    uint64_t carry = (row[LIFE_LAST] >> (LIFE_TAIL - 1)) & 1u;
+    for (int w = 0; w < LIFE_WORDS; w++) {
+        out[w] = (row[w] << 1) | carry;
+        carry = row[w] >> 63;
+    }
+    out[LIFE_LAST] &= LIFE_TAIL_MASK;
+}
+
+// Each cell takes its east neighbour's state (column + 1, wrapping).
+static inline void shiftEast(const uint64_t* row, uint64_t* out) {
+    for (int w = 0; w < LIFE_LAST; w++) {
+        out[w] = (row[w] >> 1) | ((row[w + 1] & 1u) << 63);
+    }
+    out[LIFE_LAST] = (row[LIFE_LAST] >> 1) | ((row[0] & 1u) << (LIFE_TAIL - 1));
+}
+
+LifeGrid::LifeGrid() : cur(0) {
+    clear();
+}
+
+void LifeGrid::clear() {
+    memset(cells, 0, sizeof(cells));
+}
+
+void LifeGrid::set(uint16_t row, uint16_t col, bool alive) {
+    if (row >= LIFE_ROWS || col >= LIFE_COLS) return;
+    uint64_t bit = 1ull << (col & 63u);
+    if (alive) cells[cur][row][col >> 6] |= bit;
+    else cells[cur][row][col >> 6] &= ~bit;
+}
+
+bool LifeGrid::get(uint16_t row, uint16_t col) const {
+    if (row >= LIFE_ROWS || col >= LIFE_COLS) return false;
+    return (cells[cur][row][col >> 6] >> (col & 63u)) & 1u;
+}
+
+// Adds the eight neighbour planes with full adders: the up and down rows
+// give 3-bit sums, the row itself 2, and those are folded into bits of
+// weight 1 and 2 plus a flag for 4 or more. A cell lives with 3, or with 2
+// if already alive.
+void LifeGrid::stepRow(const uint64_t* up, const uint64_t* row, const uint64_t* down, uint64_t* out) const {
+    uint64_t upW[LIFE_WORDS], upE[LIFE_WORDS];
+    uint64_t midW[LIFE_WORDS], midE[LIFE_WORDS];
+    uint64_t downW[LIFE_WORDS], downE[LIFE_WORDS];
+    shiftWest(up, upW);
+    shiftEast(up, upE);
+    shiftWest(row, midW);
+    shiftEast(row, midE);
+    shiftWest(down, downW);
+    shiftEast(down, downE);
+
+    for (int w = 0; w < LIFE_WORDS; w++) {
+        uint64_t a = upW[w], b = up[w], c = upE[w];
+        uint64_t f = downW[w], g = down[w], h = downE[w];
+        uint64_t d = midW[w], e = midE[w];
+
+        uint64_t s1 = a ^ b ^ c;
+        uint64_t c1 = (a & b) | (c & (a ^ b));
+        uint64_t s2 = f ^ g ^ h;
+        uint64_t c2 = (f & g) | (h & (f ^ g));
+        uint64_t s3 = d ^ e;
+        uint64_t c3 = d & e;
+
+        uint64_t ones = s1 ^ s2 ^ s3;
+        uint64_t c4 = (s1 & s2) | (s3 & (s1 ^ s2));
+
+        uint64_t t1 = c1 ^ c2 ^ c3;
+        uint64_t k1 = (c1 & c2) | (c3 & (c1 ^ c2));
+        uint64_t twos = t1 ^ c4;
+        uint64_t fours = k1 | (t1 & c4);
+
+        out[w] = twos & ~fours & (ones | row[w]);
+    }
+    out[LIFE_LAST] &= LIFE_TAIL_MASK;
+}
+
+void LifeGrid::step() {
+    uint8_t next = (uint8_t)(cur ^ 1u);
+    for (int r = 0; r < LIFE_ROWS; r++) {
+        int upRow = (r == 0) ? LIFE_ROWS - 1 : r - 1;
+        int downRow = (r == LIFE_ROWS - 1) ? 0 : r + 1;
+        stepRow(cells[cur][upRow], cells[cur][r], cells[cur][downRow], cells[next][r]);
+    }
+    cur = next;
+}
+
+// Runs are split by new state, and joined across word boundaries.
+void LifeGrid::forEachChangedRun(LifeRunFn fn, void* ctx) const {
+    const uint8_t old = (uint8_t)(cur ^ 1u);
+    for (uint16_t r = 0; r < LIFE_ROWS; r++) {
+        for (uint8_t alive = 0; alive < 2; alive++) {
+            uint16_t runStart = 0;
+            uint16_t runLen = 0;
+            for (uint16_t w = 0; w < LIFE_WORDS; w++) {
+                uint64_t now = cells[cur][r][w];
+                uint64_t changed = (now ^ cells[old][r][w]) & (alive ? now : ~now);
+                while (changed != 0u) {
+                    uint16_t bit = (uint16_t)__builtin_ctzll(changed);
+                    uint64_t rest = changed >> bit;
+                    uint16_t len = (rest == ~0ull) ? (uint16_t)(64u - bit) : (uint16_t)__builtin_ctzll(~rest);
+                    uint16_t col = (uint16_t)(w * 64u + bit);
+
+                    if (runLen > 0u && runStart + runLen == col) {
+                        runLen = (uint16_t)(runLen + len);
+                    } else {
+                        if (runLen > 0u) fn(ctx, r, runStart, runLen, alive != 0u);
+                        runStart = col;
+                        runLen = len;
+                    }
+                    changed = (bit + len >= 64u) ? 0u : (changed & ~((~0ull >> (64u - len)) << bit));
+                }
+            }
+            if (runLen > 0u) fn(ctx, r, runStart, runLen, alive != 0u);
+        }
+    }
+}
+
+uint32_t LifeGrid::population() const {
+    uint32_t n = 0;
+    for (int r = 0; r < LIFE_ROWS; r++) {
+        for (int w = 0; w < LIFE_WORDS; w++) n += (uint32_t)__builtin_popcountll(cells[cur][r][w]);
+    }
+    return n;
+}
@@ -0,0 +1,45 @@
+#ifndef LIFE_H
+#define LIFE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef LIFE_ROWS
+#define LIFE_ROWS 100
+#endif
+#ifndef LIFE_COLS
+#define LIFE_COLS 100
+#endif
+#define LIFE_WORDS ((LIFE_COLS + 63) / 64)
+
+// Called for each horizontal run of cells that changed in the last step(),
+// with the state they changed to.
+typedef void (*LifeRunFn)(void* ctx, uint16_t row, uint16_t col, uint16_t len, bool alive);
+
+// Conway's Life on a torus, one bit per cell in 64-bit words.
+//
+// step() works a whole word (64 cells) at a time: the eight neighbours come
+// from shifting the row above, the row itself and the row below one column
+// either way, and a bit-sliced adder counts them in parallel for every cell
+// of the word. The previous generation is kept (two buffers, no copying), so
+// the cells that changed are an XOR away.
+class LifeGrid {
+public:
+    LifeGrid();
+
+    void clear();
+    void set(uint16_t row, uint16_t col, bool alive);
+    bool get(uint16_t row, uint16_t col) const;
+
+    void step();
+    void forEachChangedRun(LifeRunFn fn, void* ctx) const;
+    uint32_t population() const;
+
+private:
+    uint64_t cells[2][LIFE_ROWS][LIFE_WORDS];
+    uint8_t cur;
+
+    void stepRow(const uint64_t* up, const uint64_t* row, const uint64_t* down, uint64_t* out) const;
+};
+
+#endif
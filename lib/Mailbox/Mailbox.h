@@ -0,0 +1,58 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// Single-producer / single-consumer hand-over of the latest value of T
+// (a triple buffer). The producer never waits for the consumer and the
+// consumer only ever sees whole values; values published while the consumer
+// is busy replace each other, so it always gets the most recent one.
+//
+// Lock-free where std::atomic<uint8_t> is: the RP2350's Cortex-M33 cores
+// and hosted builds, but not the RP2040's M0+, which has no exclusive
+// loads and stores. tools/mailbox_bench runs it across two std::threads.
+template <typename T>
+class LatestMailbox {
+public:
+    static_assert(std::atomic<uint8_t>::is_always_lock_free, "LatestMailbox needs a lock-free atomic byte");
+
+    LatestMailbox() : middle(1u), writeIdx(0u), readIdx(2u) {}
+
+    // Producer: fill the slot returned by writeSlot(), then publish() it.
+    T& writeSlot() { return slots[writeIdx]; }
+
+    void publish() {
+        uint8_t prev = middle.exchange((uint8_t)(writeIdx | FRESH), std::memory_order_acq_rel);
+        writeIdx = (uint8_t)(prev & INDEX_MASK);
+    }
+
+    // Consumer: true if fetch() would return a new value.
+    bool pending() const {
+        return (middle.load(std::memory_order_relaxed) & FRESH) != 0u;
+    }
+
+    // Consumer: the newest published value, or nullptr if nothing was
+    // published since the last fetch(). The value stays valid until the
+    // next fetch().
+    const T* fetch() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return nullptr;
+        }
+        uint8_t prev = middle.exchange(readIdx, std::memory_order_acq_rel);
+        readIdx = (uint8_t)(prev & INDEX_MASK);
+        return &slots[readIdx];
+    }
+
+private:
+    static const uint8_t INDEX_MASK = 0x03u;
+    static const uint8_t FRESH = 0x04u;
+
+    T slots[3];
+    std::atomic<uint8_t> middle;
+    uint8_t writeIdx;   // producer only
+    uint8_t readIdx;    // consumer only
+};
+
+#endif
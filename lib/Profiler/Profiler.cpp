@@ -0,0 +1,108 @@
+#include "Profiler.h"
+
+#if PROFILER_ENABLED
+
+#include <string.h>
+
+static ProfileHistogram histograms[PROF_STAGE_COUNT];
+
+static const char* const stageNames[PROF_STAGE_COUNT] = {
+    "drain",
+    "tick",
+    "prox",
+    "ttc",
+    "frame",
+    "tiles",
+    "push",
+    "ovl",
+    "warn"
+};
+
+static inline uint8_t bucketOf(uint32_t v) {
+    if (v < 4u) {
+        return (uint8_t)v;
+    }
+    uint8_t msb = (uint8_t)(31 - __builtin_clz(v));
+    return (uint8_t)(4u + (msb - 2u) * 4u + ((v >> (msb - 2u)) & 3u));
+}
+
+static inline uint32_t bucketUpper(uint8_t idx) {
+    if (idx < 4u) {
+        return idx;
+    }
+    uint8_t msb = (uint8_t)((idx - 4u) / 4u + 2u);
+    uint32_t sub = (uint32_t)((idx - 4u) % 4u);
+    uint32_t lower = (4u + sub) << (msb - 2u);
+    return lower + ((1u << (msb - 2u)) - 1u);
+}
+
+void profilerRecord(uint8_t stage, uint32_t ticks) {
+    if (stage >= PROF_STAGE_COUNT) {
+        return;
+    }
+
+    ProfileHistogram& h = histograms[stage];
+    h.counts[bucketOf(ticks)]++;
+    if (ticks > h.max) {
+        h.max = ticks;
+    }
+
+    // Halve everything long before a bucket can wrap; percentiles keep their
+    // shape and recent samples weigh a little more.
+    if (++h.total >= 0x80000000u) {
+        h.total = 0;
+        for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) {
+            h.counts[i] >>= 1;
+            h.total += h.counts[i];
+        }
+    }
+}
+
+void profilerReset(uint8_t stage) {
+    if (stage < PROF_STAGE_COUNT) {
+        memset(&histograms[stage], 0, sizeof(histograms[stage]));
+    }
+}
+
+const char* profilerStageName(uint8_t stage) {
+    return (stage < PROF_STAGE_COUNT) ? stageNames[stage] : "?";
+}
+
+static uint32_t percentile(const ProfileHistogram& h, uint32_t permille) {
+    uint64_t target = ((uint64_t)h.total * permille + 999u) / 1000u;
+    uint64_t seen = 0;
+
+    if (target == 0u) {
+        return 0u;
+    }
+    for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) {
+        seen += h.counts[i];
+        if (seen >= target) {
+            uint32_t upper = bucketUpper(i);
+            return (upper < h.max) ? upper : h.max;
+        }
+    }
+    return h.max;
+}
+
+void profilerSummary(uint8_t stage, ProfileSummary* out) {
+    if (out == nullptr) {
+        return;
+    }
+    memset(out, 0, sizeof(*out));
+    if (stage >= PROF_STAGE_COUNT) {
+        return;
+    }
+
+    const ProfileHistogram& h = histograms[stage];
+    uint32_t perUs = profilerTicksPerUs();
+    if (perUs == 0u) {
+        perUs = 1u;
+    }
+    out->count = h.total;
+    out->p50Us = percentile(h, 500u) / perUs;
+    out->p99Us = percentile(h, 990u) / perUs;
+    out->maxUs = h.max / perUs;
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Scoped timing of the main firmware stages into fixed log-bucket
+// histograms. Build with -DPROFILER_ENABLED=1 (see the *_profile env in
+// platformio.ini); otherwise PROFILE_SCOPE() expands to nothing and no
+// profiler state exists.
+//
+// Each stage must only be recorded from one core. Readers on the other core
+// may see a histogram mid-update, which is fine for a diagnostic display.
+
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 0
+#endif
+
+enum ProfileStage {
+    PROF_LINK_DRAIN = 0,   // core1: draining RX bytes through ogoa_process_byte
+    PROF_LINK_TICK,        // core1: ogoa_tick
+    PROF_PROX,             // core1: proximity sectors of one scan
+    PROF_TTC,              // core1: time-to-collision update of one scan
+    PROF_FRAME,            // core0: one scheduler pass that did work
+    PROF_TILE_RENDER,      // core0: widgets drawing into the tile buffer
+    PROF_TILE_PUSH,        // core0: pushing one tile to the panel
+    PROF_OVERLAY,          // core0: protocol overlay update
+    PROF_WARNING,          // core0: collision frame validated -> banner pushed (latency)
+    PROF_STAGE_COUNT
+};
+
+// Four sub-buckets per power of two: values 0..3 exactly, then ~19% wide
+// buckets up to 2^32.
+#define PROFILER_BUCKETS 124
+
+struct ProfileHistogram {
+    uint32_t counts[PROFILER_BUCKETS];
+    uint32_t total;
+    uint32_t max;
+};
+
+struct ProfileSummary {
+    uint32_t count;
+    uint32_t p50Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+};
+
+#if PROFILER_ENABLED
+
+#if defined(ARDUINO_ARCH_RP2040)
+#include <Arduino.h>
+static inline uint32_t profilerNow() { return rp2040.getCycleCount(); }
+static inline uint32_t profilerTicksPerUs() { return rp2040.f_cpu() / 1000000u; }
+#else
+#include <chrono>
+static inline uint32_t profilerNow() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static inline uint32_t profilerTicksPerUs() { return 1000u; }
+#endif
+
+void profilerRecord(uint8_t stage, uint32_t ticks);
+void profilerReset(uint8_t stage);
+const char* profilerStageName(uint8_t stage);
+void profilerSummary(uint8_t stage, ProfileSummary* out);
+
+class ProfileScope {
+public:
+    explicit ProfileScope(uint8_t stage) : stage(stage), start(profilerNow()) {}
+    ~ProfileScope() { profilerRecord(stage, profilerNow() - start); }
+
+private:
+    uint8_t stage;
+    uint32_t start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(stage)
+
+#else
+
+#define PROFILE_SCOPE(stage) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+#include "Proximity.h"
+
+#include <string.h>
+
+// Distances are compared as d - 1 so that 0 (bin not covered) wraps to
+// 0xFFFF and drops out of the min without a test of its own.
+struct ProxAccum {
+    uint16_t minKey;
+    uint16_t below;
+};
+
+static void reduceRun(const uint16_t* distances, uint16_t first, uint16_t count, uint16_t limitKey,
+                      uint16_t thresholdKey, ProxAccum& acc) {
+    uint16_t minKey = acc.minKey;
+    uint16_t below = acc.below;
+    const uint16_t* d = distances + first;
+
+    // Out-of-range keys are forced to 0xFFFF with a mask rather than a
+    // select, which GCC will not vectorise here.
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t key = (uint16_t)(d[i] - 1u);
+        key |= (uint16_t)-(uint16_t)(key >= limitKey);
+        minKey = (key < minKey) ? key : minKey;
+        below += (uint16_t)(key < thresholdKey);
+    }
+    acc.minKey = minKey;
+    acc.below = below;
+}
+
+// Only reached once per sector, after the min is known.
+static uint16_t findKey(const uint16_t* distances, uint16_t first, uint16_t count, uint16_t key) {
+    for (uint16_t i = 0; i < count; i++) {
+        if ((uint16_t)(distances[first + i] - 1u) == key) {
+            return (uint16_t)(first + i);
+        }
+    }
+    return PROX_NONE;
+}
+
+ProxEngine::ProxEngine(uint16_t _maxRangeMm) : maxRangeMm(_maxRangeMm), sectorCount(0) {
+    memset(sectors, 0, sizeof(sectors));
+}
+
+void ProxEngine::setSectors(const ProxSector* _sectors, uint8_t count) {
+    if (count > PROX_SECTORS_MAX) count = PROX_SECTORS_MAX;
+    for (uint8_t i = 0; i < count; i++) {
+        sectors[i] = _sectors[i];
+        sectors[i].startDeg %= PROX_BINS;
+        if (sectors[i].spanDeg > PROX_BINS) sectors[i].spanDeg = PROX_BINS;
+    }
+    sectorCount = count;
+}
+
+void ProxEngine::reduce(const uint16_t* distances, ProxReport* out) const {
+    uint16_t limitKey = (uint16_t)(maxRangeMm - 1u);
+
+    out->sectorCount = sectorCount;
+    for (uint8_t s = 0; s < sectorCount; s++) {
+        const ProxSector& sec = sectors[s];
+        ProxSectorResult& res = out->sectors[s];
+        uint16_t thresholdKey = (uint16_t)(sec.thresholdMm - 1u);
+        if (sec.thresholdMm == 0u) thresholdKey = 0u;
+
+        // A sector through 0 degrees is two contiguous runs.
+        uint16_t firstLen = sec.spanDeg;
+        if (sec.startDeg + firstLen > PROX_BINS) firstLen = (uint16_t)(PROX_BINS - sec.startDeg);
+        uint16_t wrapLen = (uint16_t)(sec.spanDeg - firstLen);
+
+        ProxAccum acc = { 0xFFFFu, 0u };
+        reduceRun(distances, sec.startDeg, firstLen, limitKey, thresholdKey, acc);
+        reduceRun(distances, 0u, wrapLen, limitKey, thresholdKey, acc);
+
+        res.belowCount = acc.below;
+        if (acc.minKey == 0xFFFFu) {
+            res.minMm = PROX_NONE;
+            res.nearestDeg = PROX_NONE;
+            continue;
+        }
+        res.minMm = (uint16_t)(acc.minKey + 1u);
+        res.nearestDeg = findKey(distances, sec.startDeg, firstLen, acc.minKey);
+        if (res.nearestDeg == PROX_NONE) {
+            res.nearestDeg = findKey(distances, 0u, wrapLen, acc.minKey);
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef PROXIMITY_H
+#define PROXIMITY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROX_BINS 360
+#define PROX_SECTORS_MAX 8
+#define PROX_MAX_RANGE_MM 4000u   // default: readings at or past this are no return
+#define PROX_NONE 0xFFFFu         // minMm / nearestDeg of a sector with no return
+
+// An arc of the scan, startDeg up to (not including) startDeg + spanDeg,
+// wrapping through 0. Samples closer than thresholdMm are counted.
+struct ProxSector {
+    uint16_t startDeg;
+    uint16_t spanDeg;
+    uint16_t thresholdMm;
+};
+
+struct ProxSectorResult {
+    uint16_t minMm;        // PROX_NONE if nothing in range
+    uint16_t nearestDeg;   // first bin at minMm, PROX_NONE if nothing in range
+    uint16_t belowCount;   // samples closer than thresholdMm
+};
+
+struct ProxReport {
+    uint8_t sectorCount;
+    ProxSectorResult sectors[PROX_SECTORS_MAX];
+};
+
+// Reduces a 360-bin scan (mm, 0 = not covered) into per-sector proximity.
+// The per-bin work is a branch-free min and compare over contiguous bins, so
+// it vectorises on hosts and stays a tight loop on the M33.
+class ProxEngine {
+public:
+    ProxEngine(uint16_t _maxRangeMm = PROX_MAX_RANGE_MM);
+
+    // Copies up to PROX_SECTORS_MAX sectors; spans are clamped to 360.
+    void setSectors(const ProxSector* sectors, uint8_t count);
+    void reduce(const uint16_t* distances, ProxReport* out) const;
+
+    uint16_t maxRangeMm;
+
+private:
+    ProxSector sectors[PROX_SECTORS_MAX];
+    uint8_t sectorCount;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include "TtcTracker.h"
+
+#include <string.h>
+
+static uint8_t ttcLevel(uint16_t ttcMs) {
+    if (ttcMs < TTC_DANGER_MS) return TTC_LEVEL_DANGER;
+    if (ttcMs < TTC_CAUTION_MS) return TTC_LEVEL_CAUTION;
+    if (ttcMs < TTC_NOTICE_MS) return TTC_LEVEL_NOTICE;
+    return TTC_LEVEL_NONE;
+}
+
+TtcTracker::TtcTracker() : sectorCount(0) {
+    memset(sectorDeg, 0, sizeof(sectorDeg));
+    reset();
+}
+
+void TtcTracker::setSectorAngles(const uint16_t* vehicleDeg, uint8_t count) {
+    if (count > PROX_SECTORS_MAX) count = PROX_SECTORS_MAX;
+    for (uint8_t i = 0; i < count; i++) sectorDeg[i] = vehicleDeg[i] % PROX_BINS;
+    sectorCount = count;
+    reset();
+}
+
+void TtcTracker::reset() {
+    memset(closingQ8, 0, sizeof(closingQ8));
+    speedValid = 0;
+    memset(prevMinMm, 0xFF, sizeof(prevMinMm));
+    prevMs = 0;
+    primed = false;
+}
+
+void TtcTracker::update(const ProxReport& prox, uint32_t nowMs, bool moving, uint16_t travelDeg, TtcReport* out) {
+    uint32_t dtMs = nowMs - prevMs;
+    bool usable = primed && dtMs > 0u && dtMs <= TTC_MAX_GAP_MS;
+    uint8_t count = (prox.sectorCount < sectorCount) ? prox.sectorCount : sectorCount;
+
+    out->sectorCount = count;
+    out->level = TTC_LEVEL_NONE;
+    out->worstSector = 0;
+
+    for (uint8_t s = 0; s < count; s++) {
+        uint16_t minMm = prox.sectors[s].minMm;
+        TtcSector& res = out->sectors[s];
+
+        // Closing speed in mm/s, Q8, only across two readings of something.
+        if (usable && minMm != PROX_NONE && prevMinMm[s] != PROX_NONE) {
+            int32_t deltaMm = (int32_t)prevMinMm[s] - (int32_t)minMm;
+            if (deltaMm > TTC_MAX_STEP_MM) deltaMm = TTC_MAX_STEP_MM;
+            if (deltaMm < -TTC_MAX_STEP_MM) deltaMm = -TTC_MAX_STEP_MM;
+            int32_t closingQ8Now = (deltaMm * 1000 * 256) / (int32_t)dtMs;
+            if (speedValid & (1u << s)) {
+                closingQ8[s] += (closingQ8Now - closingQ8[s]) >> TTC_SMOOTH_SHIFT;
+            } else {
+                closingQ8[s] = closingQ8Now;
+                speedValid |= (uint8_t)(1u << s);
+            }
+        } else {
+            closingQ8[s] = 0;
+            speedValid &= (uint8_t)~(1u << s);
+        }
+        prevMinMm[s] = minMm;
+
+        int32_t closing = closingQ8[s] >> 8;
+        res.closingMmS = (int16_t)((closing > 32767) ? 32767 : ((closing < -32768) ? -32768 : closing));
+        res.ttcMs = TTC_NONE;
+        res.level = TTC_LEVEL_NONE;
+
+        int diff = (int)sectorDeg[s] - (int)travelDeg;
+        if (diff < 0) diff = -diff;
+        if (diff > 180) diff = 360 - diff;
+        if (!moving || diff > (int)TTC_CONE_DEG || minMm == PROX_NONE || closing < TTC_MIN_CLOSING_MM_S) {
+            continue;
+        }
+
+        uint32_t ttc = ((uint32_t)minMm * 1000u) / (uint32_t)closing;
+        if (ttc < TTC_MAX_MS) {
+            res.ttcMs = (uint16_t)ttc;
+            res.level = ttcLevel(res.ttcMs);
+        }
+        if (res.level > out->level ||
+            (res.level == out->level && res.level != TTC_LEVEL_NONE && res.ttcMs < out->sectors[out->worstSector].ttcMs)) {
+            out->level = res.level;
+            out->worstSector = s;
+        }
+    }
+
+    prevMs = nowMs;
+    primed = true;
+}
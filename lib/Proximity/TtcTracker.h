@@ -0,0 +1,67 @@
+#ifndef TTC_TRACKER_H
+#define TTC_TRACKER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Proximity.h"
+
+#define TTC_NONE 0xFFFFu            // ttcMs of a sector that is not closing
+#define TTC_MAX_MS 10000u           // longer estimates are reported as TTC_NONE
+#define TTC_MIN_CLOSING_MM_S 50     // slower closing is noise
+#define TTC_MAX_GAP_MS 1000u        // scans further apart than this restart the estimate
+#define TTC_MAX_STEP_MM 4000        // keeps the Q8 speed and its EMA step inside int32
+#define TTC_SMOOTH_SHIFT 2          // closing speed EMA weight 1/4
+#define TTC_CONE_DEG 90u            // sectors further off the direction of travel are ignored
+#define TTC_NOTICE_MS 4000u         // escalation thresholds
+#define TTC_CAUTION_MS 2000u
+#define TTC_DANGER_MS 1000u
+
+enum TtcLevel {
+    TTC_LEVEL_NONE = 0,
+    TTC_LEVEL_NOTICE,
+    TTC_LEVEL_CAUTION,
+    TTC_LEVEL_DANGER
+};
+
+struct TtcSector {
+    uint16_t ttcMs;         // TTC_NONE if not closing or off the direction of travel
+    int16_t closingMmS;     // smoothed, positive = getting closer
+    uint8_t level;          // TtcLevel
+};
+
+struct TtcReport {
+    uint8_t sectorCount;
+    uint8_t level;          // worst sector
+    uint8_t worstSector;
+    TtcSector sectors[PROX_SECTORS_MAX];
+};
+
+// Time to collision per proximity sector, from how fast each sector's
+// nearest return closes between consecutive complete scans. Speeds are
+// smoothed in Q8 fixed point; an update is a handful of integer operations
+// and one division per sector, whatever the scene.
+//
+// Only sectors the vehicle is being driven towards (joystick heading, see
+// CollisionGuard) get an estimate, so walls passing alongside and obstacles
+// behind a vehicle at rest do not raise it.
+class TtcTracker {
+public:
+    TtcTracker();
+
+    // Vehicle-relative centre of each sector (0 = ahead, clockwise).
+    void setSectorAngles(const uint16_t* vehicleDeg, uint8_t count);
+    void reset();
+    void update(const ProxReport& prox, uint32_t nowMs, bool moving, uint16_t travelDeg, TtcReport* out);
+
+private:
+    uint16_t sectorDeg[PROX_SECTORS_MAX];
+    uint8_t sectorCount;
+
+    int32_t closingQ8[PROX_SECTORS_MAX];
+    uint8_t speedValid;   // bit per sector: closingQ8 holds a measurement
+    uint16_t prevMinMm[PROX_SECTORS_MAX];
+    uint32_t prevMs;
+    bool primed;
+};
+
+#endif
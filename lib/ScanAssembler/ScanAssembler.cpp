@@ -0,0 +1,73 @@
+#include "ScanAssembler.h"
+
+#include <string.h>
+
+ScanAssembler::ScanAssembler(uint32_t _timeoutMs)
+    : timeoutMs(_timeoutMs), completeScans(0), partialScans(0), chunks(0), sink(nullptr), sinkCtx(nullptr),
+      coverage(0), active(false), scanSeq(0), startedMs(0) {
+    memset(back, 0, sizeof(back));
+    memset(covered, 0, sizeof(covered));
+}
+
+void ScanAssembler::setSink(ScanSinkFn fn, void* ctx) {
+    sink = fn;
+    sinkCtx = ctx;
+}
+
+void ScanAssembler::finish(bool complete) {
+    if (complete) completeScans++;
+    else partialScans++;
+
+    if (sink != nullptr) sink(sinkCtx, back, coverage, complete);
+
+    memset(back, 0, sizeof(back));
+    memset(covered, 0, sizeof(covered));
+    coverage = 0;
+    active = false;
+}
+
+void ScanAssembler::add(const ScanChunk& chunk, uint32_t nowMs) {
+    if (chunk.distances == nullptr || chunk.count == 0u || chunk.deltaTheta == 0u) return;
+    chunks++;
+
+    if (active) {
+        bool newSweep = false;
+        if (chunk.sequenced) {
+            newSweep = chunk.scanSeq != scanSeq;
+        } else {
+            uint16_t bin = chunk.startTheta % SCAN_BINS;
+            for (uint8_t i = 0; i < chunk.count && !newSweep; i++) {
+                newSweep = isCovered(bin);
+                bin = (uint16_t)((bin + chunk.deltaTheta) % SCAN_BINS);
+            }
+        }
+        if (newSweep) finish(false);
+    }
+
+    if (!active) {
+        active = true;
+        scanSeq = chunk.scanSeq;
+        startedMs = nowMs;
+    }
+
+    uint16_t bin = chunk.startTheta % SCAN_BINS;
+    for (uint8_t i = 0; i < chunk.count; i++) {
+        back[bin] = (uint16_t)(chunk.distances[2u * i] | (chunk.distances[2u * i + 1u] << 8));
+        if (!isCovered(bin)) {
+            covered[bin >> 5] |= 1u << (bin & 31u);
+            coverage++;
+        }
+        bin = (uint16_t)((bin + chunk.deltaTheta) % SCAN_BINS);
+    }
+
+    // A sequenced sweep may cover less than 360 degrees; its last chunk ends it.
+    if (coverage == SCAN_BINS || (chunk.sequenced && chunk.last)) {
+        finish(true);
+    }
+}
+
+void ScanAssembler::poll(uint32_t nowMs) {
+    if (active && timeoutMs > 0u && (nowMs - startedMs) >= timeoutMs) {
+        finish(false);
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef SCAN_ASSEMBLER_H
+#define SCAN_ASSEMBLER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCAN_BINS 360
+#define SCAN_TIMEOUT_MS 250u   // default: publish a partial scan this long after its first chunk
+
+// One LiDAR frame's worth of samples. Distances are little-endian uint16 (mm)
+// straight from the payload.
+struct ScanChunk {
+    uint16_t startTheta;
+    uint8_t deltaTheta;
+    uint8_t count;
+    const uint8_t* distances;
+    bool sequenced;    // scanSeq and last are meaningful
+    uint8_t scanSeq;   // same for every chunk of one sweep
+    bool last;         // final chunk of the sweep
+};
+
+// Called with a finished scan. Bins the sweep did not cover are 0. The
+// buffer is only valid during the call.
+typedef void (*ScanSinkFn)(void* ctx, const uint16_t* distances, uint16_t coverage, bool complete);
+
+// Collects one sensor's chunks into a back buffer and hands a scan to the
+// sink only once it is finished, so consumers never see two sweeps mixed.
+//
+// A scan is complete when every bin has been written or, for sequenced
+// chunks, when the last chunk arrives. It is cut short, and handed over as
+// partial, when a chunk from a new sweep arrives first (a different scanSeq,
+// or for unsequenced chunks a bin that was already written) or when
+// timeoutMs passes after its first chunk.
+class ScanAssembler {
+public:
+    ScanAssembler(uint32_t _timeoutMs = SCAN_TIMEOUT_MS);
+
+    void setSink(ScanSinkFn fn, void* ctx);
+    void add(const ScanChunk& chunk, uint32_t nowMs);
+    // Call regularly to apply the timeout.
+    void poll(uint32_t nowMs);
+
+    uint32_t timeoutMs;
+    uint32_t completeScans;
+    uint32_t partialScans;
+    uint32_t chunks;
+
+private:
+    ScanSinkFn sink;
+    void* sinkCtx;
+
+    uint16_t back[SCAN_BINS];
+    uint32_t covered[(SCAN_BINS + 31) / 32];
+    uint16_t coverage;
+    bool active;
+    uint8_t scanSeq;
+    uint32_t startedMs;
+
+    bool isCovered(uint16_t bin) const { return (covered[bin >> 5] >> (bin & 31u)) & 1u; }
+    void finish(bool complete);
+};
+
+#endif
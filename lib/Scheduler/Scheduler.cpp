@@ -0,0 +1,124 @@
+#include "Scheduler.h"
+
+#include <string.h>
+
+Scheduler::Scheduler(SchedulerClockFn _clock, uint32_t _frameBudgetUs)
+    : clock(_clock), frameBudgetUs(_frameBudgetUs), count(0) {
+    memset(tasks, 0, sizeof(tasks));
+}
+
+int Scheduler::add(const SchedulerTaskConfig& config) {
+    if (count >= SCHEDULER_MAX_TASKS || config.fn == nullptr) {
+        return -1;
+    }
+
+    Task& task = tasks[count];
+    memset(&task, 0, sizeof(task));
+    task.cfg = config;
+    if (task.cfg.priority > SCHED_LOW) {
+        task.cfg.priority = SCHED_LOW;
+    }
+    return count++;
+}
+
+// A task with a ready function is asked every pass, even while its rate cap
+// holds it back, so that its deadline runs from the data it waits for and
+// not from the end of the cap.
+bool Scheduler::checkDue(Task& task, uint32_t now) {
+    if (task.due) {
+        return true;
+    }
+    if (task.cfg.ready != nullptr) {
+        if (!task.cfg.ready(task.cfg.ctx)) {
+            task.readyHeld = false;
+            return false;
+        }
+        if (!task.readyHeld) {
+            task.readyHeld = true;
+            task.readySinceUs = now;
+        }
+    }
+    if (task.started && task.cfg.intervalUs != 0u && (now - task.lastStartUs) < task.cfg.intervalUs) {
+        return false;
+    }
+
+    task.due = true;
+    task.dueSinceUs = now;
+    if (task.cfg.ready == nullptr) {
+        task.readySinceUs = now;
+    }
+    return true;
+}
+
+void Scheduler::run(Task& task) {
+    uint32_t t0 = clock();
+    task.cfg.fn(task.cfg.ctx);
+    uint32_t t1 = clock();
+    uint32_t took = t1 - t0;
+
+    SchedulerTaskStats& st = task.stats;
+    st.runs++;
+    st.lastUs = took;
+    if (took > st.maxUs) {
+        st.maxUs = took;
+    }
+    if (task.cfg.budgetUs != 0u && took > task.cfg.budgetUs) {
+        st.overruns++;
+    }
+    if (task.cfg.deadlineUs != 0u && (t1 - task.readySinceUs) > task.cfg.deadlineUs) {
+        st.misses++;
+    }
+
+    task.lastStartUs = t0;
+    task.started = true;
+    task.due = false;
+    task.readyHeld = false;
+}
+
+uint8_t Scheduler::runPass() {
+    uint32_t passStart = clock();
+    uint8_t ran = 0;
+
+    for (uint8_t prio = SCHED_CRITICAL; prio <= SCHED_LOW; prio++) {
+        for (uint8_t i = 0; i < count; i++) {
+            Task& task = tasks[i];
+            if (task.cfg.priority != prio) {
+                continue;
+            }
+
+            uint32_t now = clock();
+            if (!checkDue(task, now)) {
+                continue;
+            }
+
+            if (prio == SCHED_LOW) {
+                bool overBudget = (now - passStart) + task.cfg.budgetUs > frameBudgetUs;
+                bool starved = task.cfg.maxDeferUs != 0u && (now - task.dueSinceUs) >= task.cfg.maxDeferUs;
+                if (overBudget && !starved) {
+                    task.stats.deferrals++;
+                    continue;
+                }
+            }
+
+            run(task);
+            ran++;
+        }
+    }
+    return ran;
+}
+
+uint32_t Scheduler::totalMisses() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        total += tasks[i].stats.misses;
+    }
+    return total;
+}
+
+uint32_t Scheduler::totalDeferrals() const {
+    uint32_t total = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        total += tasks[i].stats.deferrals;
+    }
+    return total;
+}
@@ -0,0 +1,82 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCHEDULER_MAX_TASKS 8
+
+typedef uint32_t (*SchedulerClockFn)(void);     // microseconds, may wrap
+typedef void (*SchedulerTaskFn)(void* ctx);
+typedef bool (*SchedulerReadyFn)(void* ctx);
+
+enum SchedulerPriority {
+    SCHED_CRITICAL = 0,   // runs every time it is due, first
+    SCHED_NORMAL = 1,     // runs every time it is due
+    SCHED_LOW = 2         // deferred while the pass is over its frame budget
+};
+
+struct SchedulerTaskConfig {
+    const char* name;
+    SchedulerTaskFn fn;
+    void* ctx;
+    SchedulerReadyFn ready;   // optional: only due while this returns true
+    uint32_t intervalUs;      // minimum time between starts (rate cap), 0 = every pass
+    uint32_t budgetUs;        // expected run time
+    uint32_t deadlineUs;      // from ready turning true (or, without ready, from
+                              // becoming due) to finishing, 0 = none
+    uint8_t priority;
+    uint32_t maxDeferUs;      // SCHED_LOW: run anyway once deferred this long
+};
+
+struct SchedulerTaskStats {
+    uint32_t runs;
+    uint32_t misses;      // finished later than deadlineUs, see deadlineUs
+    uint32_t overruns;    // ran longer than budgetUs
+    uint32_t deferrals;   // passes a due SCHED_LOW task was held back
+    uint32_t lastUs;
+    uint32_t maxUs;
+};
+
+// Cooperative, run-to-completion scheduler for the render loop. Call
+// runPass() from loop(); each pass runs the tasks that are due in priority
+// order, then registration order. Time comes from the clock function only,
+// so a virtual clock can drive it on the host.
+class Scheduler {
+public:
+    Scheduler(SchedulerClockFn _clock, uint32_t _frameBudgetUs);
+
+    // Returns the task id, or -1 if the table is full.
+    int add(const SchedulerTaskConfig& config);
+
+    // Returns the number of tasks that ran.
+    uint8_t runPass();
+
+    uint8_t taskCount() const { return count; }
+    const SchedulerTaskConfig& config(uint8_t id) const { return tasks[id].cfg; }
+    const SchedulerTaskStats& stats(uint8_t id) const { return tasks[id].stats; }
+    uint32_t totalMisses() const;
+    uint32_t totalDeferrals() const;
+
+private:
+    struct Task {
+        SchedulerTaskConfig cfg;
+        SchedulerTaskStats stats;
+        uint32_t lastStartUs;
+        uint32_t dueSinceUs;
+        uint32_t readySinceUs;   // first pass ready held, rate cap included
+        bool started;
+        bool due;
+        bool readyHeld;
+    };
+
+    SchedulerClockFn clock;
+    uint32_t frameBudgetUs;
+    Task tasks[SCHEDULER_MAX_TASKS];
+    uint8_t count;
+
+    bool checkDue(Task& task, uint32_t now);
+    void run(Task& task);
+};
+
+#endif
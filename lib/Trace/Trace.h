@@ -0,0 +1,93 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// Must be a power of two.
+#ifndef TRACE_RECORDS
+#define TRACE_RECORDS 256u
+#endif
+
+#if (TRACE_RECORDS & (TRACE_RECORDS - 1u)) != 0u
+#error "TRACE_RECORDS must be a power of two"
+#endif
+
+// One event: when, what (an id the writer defines), and up to three
+// integers. Turning it into text is left to whoever reads it.
+struct TraceRecord {
+    uint32_t us;
+    uint8_t id;
+    uint8_t arg0;
+    uint16_t arg1;
+    uint32_t arg2;
+};
+
+// Fixed ring of the last TRACE_RECORDS events from one writer. record() is
+// a handful of stores and no formatting, so it can sit on hot paths.
+//
+// Readers on any core copy records out by number: record n is the n-th ever
+// written, count() - 1 the newest. A record the writer may be overwriting
+// while it is copied counts as lost, so readers on another core see at most
+// TRACE_RECORDS - 1 of them.
+//
+// This is a seqlock. The writer bumps `started`, then issues a release fence
+// before storing the fields, so a reader whose copy saw any of those stores
+// sees the bump after its own acquire fence and discards the copy. The
+// fields are relaxed atomics (plain loads and stores on the M33), so a copy
+// that races the writer is a lost record, not undefined behaviour. `head`
+// publishes finished records with release/acquire.
+class TraceRing {
+public:
+    TraceRing() : head(0u), started(0u) {}
+
+    // Writer only.
+    void record(uint32_t us, uint8_t id, uint8_t arg0 = 0u, uint16_t arg1 = 0u, uint32_t arg2 = 0u) {
+        uint32_t n = head.load(std::memory_order_relaxed);
+        started.store(n + 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot& s = slots[n & (TRACE_RECORDS - 1u)];
+        s.us.store(us, std::memory_order_relaxed);
+        s.tag.store((uint32_t)id | ((uint32_t)arg0 << 8) | ((uint32_t)arg1 << 16), std::memory_order_relaxed);
+        s.arg2.store(arg2, std::memory_order_relaxed);
+        head.store(n + 1u, std::memory_order_release);
+    }
+
+    // Records written so far (wraps at 2^32).
+    uint32_t count() const {
+        return head.load(std::memory_order_acquire);
+    }
+
+    // False if record n is not written yet or no longer in the ring.
+    bool read(uint32_t n, TraceRecord* out) const {
+        uint32_t age = count() - n;
+        if (age == 0u || age >= TRACE_RECORDS) {
+            return false;
+        }
+        const Slot& s = slots[n & (TRACE_RECORDS - 1u)];
+        uint32_t tag = s.tag.load(std::memory_order_relaxed);
+        out->us = s.us.load(std::memory_order_relaxed);
+        out->id = (uint8_t)tag;
+        out->arg0 = (uint8_t)(tag >> 8);
+        out->arg1 = (uint16_t)(tag >> 16);
+        out->arg2 = s.arg2.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Rewriting the slot for record n + TRACE_RECORDS sets started past this.
+        return started.load(std::memory_order_relaxed) - n <= TRACE_RECORDS;
+    }
+
+private:
+    // A TraceRecord packed into three words.
+    struct Slot {
+        std::atomic<uint32_t> us;
+        std::atomic<uint32_t> tag;    // id, arg0 << 8, arg1 << 16
+        std::atomic<uint32_t> arg2;
+    };
+
+    Slot slots[TRACE_RECORDS];
+    std::atomic<uint32_t> head;       // records finished
+    std::atomic<uint32_t> started;    // records begun; head or head + 1
+};
+
+#endif
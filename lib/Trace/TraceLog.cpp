@@ -0,0 +1,50 @@
+#include "TraceLog.h"
+
+TraceLog::TraceLog(const TraceRing* _ring, TraceFormatFn _format)
+    : lines(0), bytes(0), dropped(0), ring(_ring), format(_format), port(nullptr), next(0), lineLen(0), linePos(0) {}
+
+void TraceLog::begin(Stream* _port) {
+    port = _port;
+    uint32_t count = ring->count();
+    next = (count > TRACE_RECORDS - 1u) ? count - (TRACE_RECORDS - 1u) : 0u;
+    lineLen = 0;
+    linePos = 0;
+}
+
+bool TraceLog::nextLine() {
+    if (next == ring->count()) return false;
+
+    TraceRecord rec;
+    int n;
+    if (!ring->read(next, &rec)) {
+        // Lapped: carry on from a little after the oldest record left.
+        uint32_t resume = ring->count() - (TRACE_RECORDS / 2u);
+        n = snprintf(line, sizeof(line), "... %lu events dropped\r\n", (unsigned long)(resume - next));
+        dropped += resume - next;
+        next = resume;
+    } else {
+        n = snprintf(line, sizeof(line), "%10lu ", (unsigned long)rec.us);
+        n += (int)format(rec, line + n, sizeof(line) - (size_t)n - 2u);
+        line[n++] = '\r';
+        line[n++] = '\n';
+        next++;
+    }
+    lineLen = (uint8_t)((n < (int)sizeof(line)) ? n : (int)sizeof(line) - 1);
+    linePos = 0;
+    lines++;
+    return true;
+}
+
+size_t TraceLog::poll() {
+    if (port == nullptr) return 0;
+    if (linePos == lineLen && !nextLine()) return 0;
+
+    int room = port->availableForWrite();
+    if (room <= 0) return 0;
+    size_t n = (size_t)(lineLen - linePos);
+    if ((size_t)room < n) n = (size_t)room;
+    n = port->write((const uint8_t*)line + linePos, n);
+    linePos = (uint8_t)(linePos + n);
+    bytes += (uint32_t)n;
+    return n;
+}
@@ -0,0 +1,45 @@
+#ifndef TRACE_LOG_H
+#define TRACE_LOG_H
+
+#include <Arduino.h>
+#include "Trace.h"
+
+#define TRACE_LOG_LINE_CHARS 80
+
+// Turns one record into text (no line ending); returns its length.
+typedef size_t (*TraceFormatFn)(const TraceRecord& rec, char* out, size_t len);
+
+// Debug log: the records of a TraceRing as text lines on a port of their
+// own. poll() formats at most one line and writes only what the port takes
+// without blocking (availableForWrite()), so a slow or unconnected port
+// costs the caller almost nothing; when the ring laps the log, the lost
+// records are counted and noted in the log instead.
+//
+// Poll from the ring's writer, or from one other core.
+class TraceLog {
+public:
+    TraceLog(const TraceRing* _ring, TraceFormatFn _format);
+
+    void begin(Stream* _port);
+
+    // Returns the number of bytes written.
+    size_t poll();
+
+    uint32_t lines;
+    uint32_t bytes;
+    uint32_t dropped;   // records lapped before they were logged
+
+private:
+    const TraceRing* ring;
+    TraceFormatFn format;
+    Stream* port;
+    uint32_t next;      // next record to log
+
+    char line[TRACE_LOG_LINE_CHARS];
+    uint8_t lineLen;
+    uint8_t linePos;
+
+    bool nextLine();
+};
+
+#endif
@@ -0,0 +1,168 @@
+#include "Compositor.h"
+#include "Profiler.h"
+
+#if (COMPOSITOR_TILE % 8) != 0
+#error "COMPOSITOR_TILE must be a multiple of 8 (tiles start on shadow bytes)"
+#endif
+
+Compositor::Compositor(TFT_eSPI* _tft, int16_t _screenW, int16_t _screenH, uint16_t _background)
+    : tilesPushed(0), tft(_tft), tile(_tft), screenW(_screenW), screenH(_screenH),
+      background(_background), widgetCount(0), yieldFn(nullptr), yieldCtx(nullptr), shadow(nullptr),
+      ownsShadow(false) {
+    cols = (uint8_t)((screenW + COMPOSITOR_TILE - 1) / COMPOSITOR_TILE);
+    rows = (uint8_t)((screenH + COMPOSITOR_TILE - 1) / COMPOSITOR_TILE);
+    if ((uint16_t)cols * rows > COMPOSITOR_MAX_TILES) {
+        rows = (uint8_t)(COMPOSITOR_MAX_TILES / cols);
+    }
+    shadowStride = (uint16_t)((screenW + 7) / 8);
+    memset(dirtyBits, 0, sizeof(dirtyBits));
+    memset(&pushStats, 0, sizeof(pushStats));
+}
+
+Compositor::~Compositor() {
+    tile.deleteSprite();
+    if (ownsShadow) free(shadow);
+}
+
+bool Compositor::begin(uint8_t* shadowBuffer) {
+    tile.setColorDepth(16);
+    if (tile.createSprite(COMPOSITOR_TILE, COMPOSITOR_TILE) == nullptr) return false;
+
+#if COMPOSITOR_SHADOW
+    // Start out assuming nothing about the panel contents.
+    ownsShadow = shadowBuffer == nullptr;
+    shadow = ownsShadow ? (uint8_t*)malloc((size_t)shadowStride * screenH) : shadowBuffer;
+    if (shadow != nullptr) memset(shadow, 0xFF, (size_t)shadowStride * screenH);
+#else
+    (void)shadowBuffer;
+#endif
+    return true;
+}
+
+bool Compositor::add(Widget* widget) {
+    if (widget == nullptr || widgetCount >= COMPOSITOR_MAX_WIDGETS) return false;
+
+    widgets[widgetCount++] = widget;
+    widget->compositor = this;
+    widget->invalidate();
+    return true;
+}
+
+void Compositor::invalidate(int16_t rx, int16_t ry, int16_t rw, int16_t rh) {
+    int16_t x0 = rx < 0 ? 0 : rx;
+    int16_t y0 = ry < 0 ? 0 : ry;
+    int16_t x1 = rx + rw > screenW ? screenW : rx + rw;
+    int16_t y1 = ry + rh > screenH ? screenH : ry + rh;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    uint8_t c0 = (uint8_t)(x0 / COMPOSITOR_TILE);
+    uint8_t c1 = (uint8_t)((x1 - 1) / COMPOSITOR_TILE);
+    uint8_t r0 = (uint8_t)(y0 / COMPOSITOR_TILE);
+    uint8_t r1 = (uint8_t)((y1 - 1) / COMPOSITOR_TILE);
+    if (r1 >= rows) r1 = rows - 1;
+
+    for (uint8_t r = r0; r <= r1; r++) {
+        for (uint8_t c = c0; c <= c1; c++) {
+            uint16_t idx = (uint16_t)r * cols + c;
+            dirtyBits[idx >> 5] |= 1u << (idx & 31u);
+        }
+    }
+}
+
+void Compositor::invalidateAll() {
+    if (shadow != nullptr) memset(shadow, 0xFF, (size_t)shadowStride * screenH);
+    invalidate(0, 0, screenW, screenH);
+}
+
+bool Compositor::pending() const {
+    for (uint16_t word = 0; word < (COMPOSITOR_MAX_TILES + 31) / 32; word++) {
+        if (dirtyBits[word] != 0u) return true;
+    }
+    return false;
+}
+
+uint16_t Compositor::update() {
+    uint16_t pushed = 0;
+
+    for (uint16_t word = 0; word < (COMPOSITOR_MAX_TILES + 31) / 32; word++) {
+        uint32_t bits = dirtyBits[word];
+        dirtyBits[word] = 0;
+        while (bits != 0u) {
+            uint16_t idx = (uint16_t)(word * 32u + (uint16_t)__builtin_ctz(bits));
+            bits &= bits - 1u;
+            renderTile((uint8_t)(idx % cols), (uint8_t)(idx / cols));
+            pushed++;
+            if (yieldFn != nullptr && yieldFn(yieldCtx)) {
+                dirtyBits[word] |= bits;
+                tilesPushed += pushed;
+                return pushed;
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < widgetCount; i++) {
+        widgets[i]->dirty = false;
+    }
+    tilesPushed += pushed;
+    return pushed;
+}
+
+void Compositor::setYield(CompositorYieldFn fn, void* ctx) {
+    yieldFn = fn;
+    yieldCtx = ctx;
+}
+
+uint16_t Compositor::updateWidget(const Widget* widget) {
+    int16_t x0 = widget->x < 0 ? 0 : widget->x;
+    int16_t y0 = widget->y < 0 ? 0 : widget->y;
+    int16_t x1 = widget->x + widget->w > screenW ? screenW : widget->x + widget->w;
+    int16_t y1 = widget->y + widget->h > screenH ? screenH : widget->y + widget->h;
+    if (x0 >= x1 || y0 >= y1) return 0;
+
+    uint8_t c0 = (uint8_t)(x0 / COMPOSITOR_TILE);
+    uint8_t c1 = (uint8_t)((x1 - 1) / COMPOSITOR_TILE);
+    uint8_t r0 = (uint8_t)(y0 / COMPOSITOR_TILE);
+    uint8_t r1 = (uint8_t)((y1 - 1) / COMPOSITOR_TILE);
+    if (r1 >= rows) r1 = rows - 1;
+
+    uint16_t pushed = 0;
+    for (uint8_t r = r0; r <= r1; r++) {
+        for (uint8_t c = c0; c <= c1; c++) {
+            uint16_t idx = (uint16_t)r * cols + c;
+            uint32_t bit = 1u << (idx & 31u);
+            if ((dirtyBits[idx >> 5] & bit) == 0u) continue;
+            dirtyBits[idx >> 5] &= ~bit;
+            renderTile(c, r);
+            pushed++;
+        }
+    }
+    tilesPushed += pushed;
+    return pushed;
+}
+
+size_t Compositor::bufferBytes() const {
+    size_t bytes = (size_t)COMPOSITOR_TILE * COMPOSITOR_TILE * 2u;
+    if (shadow != nullptr) bytes += (size_t)shadowStride * screenH;
+    return bytes;
+}
+
+void Compositor::renderTile(uint8_t col, uint8_t row) {
+    int16_t tx = (int16_t)col * COMPOSITOR_TILE;
+    int16_t ty = (int16_t)row * COMPOSITOR_TILE;
+
+    {
+        PROFILE_SCOPE(PROF_TILE_RENDER);
+        tile.fillSprite(background);
+        for (uint8_t i = 0; i < widgetCount; i++) {
+            Widget* wgt = widgets[i];
+            if (wgt->x >= tx + COMPOSITOR_TILE || wgt->x + wgt->w <= tx ||
+                wgt->y >= ty + COMPOSITOR_TILE || wgt->y + wgt->h <= ty) {
+                continue;
+            }
+            wgt->render(&tile, wgt->x - tx, wgt->y - ty);
+        }
+    }
+    PROFILE_SCOPE(PROF_TILE_PUSH);
+    uint8_t* tileShadow = (shadow != nullptr) ? shadow + (size_t)ty * shadowStride + tx / 8 : nullptr;
+    spanPush(tft, &tile, tx, ty, background, tileShadow, shadowStride, &pushStats);
+}
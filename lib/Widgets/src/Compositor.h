@@ -0,0 +1,86 @@
+#ifndef COMPOSITOR_H
+#define COMPOSITOR_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "Widget.h"
+#include "SpanPush.h"
+
+#define COMPOSITOR_TILE 32
+#define COMPOSITOR_MAX_TILES 256
+#define COMPOSITOR_MAX_WIDGETS 12
+
+// Keep a 1-bit map of which panel pixels are not background so tiles can be
+// pushed as spans that skip background the panel already shows.
+#ifndef COMPOSITOR_SHADOW
+#define COMPOSITOR_SHADOW 1
+#endif
+
+// Size of the shadow map for a screen, for callers that reserve it statically.
+#define COMPOSITOR_SHADOW_BYTES(w, h) ((((size_t)(w) + 7u) / 8u) * (size_t)(h))
+
+// Draws the screen as a grid of square tiles through one shared RGB565 tile
+// sprite. Widgets report the rectangles they changed; only tiles touching
+// those rectangles are rendered (every overlapping widget, in the order they
+// were added) and pushed to the panel.
+//
+// The compositor assumes it owns the screen: after drawing to the panel
+// directly, call invalidateAll() to repaint everything.
+typedef bool (*CompositorYieldFn)(void* ctx);
+
+class Compositor {
+public:
+    Compositor(TFT_eSPI* _tft, int16_t _screenW, int16_t _screenH, uint16_t _background = TFT_BLACK);
+    ~Compositor();
+
+    // Allocates the tile sprite, and the shadow map unless a buffer of
+    // COMPOSITOR_SHADOW_BYTES is passed in. False if the tile sprite could
+    // not be allocated.
+    bool begin(uint8_t* shadowBuffer = nullptr);
+    bool add(Widget* widget);
+
+    void invalidate(int16_t rx, int16_t ry, int16_t rw, int16_t rh);
+    void invalidateAll();
+
+    // True if any tile is waiting to be rendered.
+    bool pending() const;
+
+    // Render and push every dirty tile, or stop early once the yield check
+    // (if set) returns true; what is left stays dirty. Returns the number of
+    // tiles pushed.
+    uint16_t update();
+    void setYield(CompositorYieldFn fn, void* ctx);
+
+    // Render and push only the dirty tiles under one widget, ahead of the
+    // rest (which stay dirty for the next update()). For urgent widgets that
+    // cannot wait for the frame rate cap. Returns the number of tiles pushed.
+    uint16_t updateWidget(const Widget* widget);
+
+    size_t bufferBytes() const;
+
+    uint32_t tilesPushed;
+    SpanPushStats pushStats;
+
+private:
+    TFT_eSPI* tft;
+    TFT_eSprite tile;
+    int16_t screenW, screenH;
+    uint8_t cols, rows;
+    uint16_t background;
+
+    Widget* widgets[COMPOSITOR_MAX_WIDGETS];
+    uint8_t widgetCount;
+
+    uint32_t dirtyBits[(COMPOSITOR_MAX_TILES + 31) / 32];
+
+    CompositorYieldFn yieldFn;
+    void* yieldCtx;
+
+    uint8_t* shadow;
+    uint16_t shadowStride;
+    bool ownsShadow;
+
+    void renderTile(uint8_t col, uint8_t row);
+};
+
+#endif
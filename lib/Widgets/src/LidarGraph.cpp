@@ -1,30 +1,95 @@
 #include "LidarGraph.h"
 
-LidarGraph::LidarGraph(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t c)
-    : Widget(tft, x, y, w, h), color(c), maxVal(100) {
-    data.reserve(w);
-    for (int i = 0; i < w; i++) data.push_back(0);
+// Samples are plotted inside the 1px frame: sample i sits in column i + 1.
+LidarGraph::LidarGraph(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t c, uint8_t depth)
+    : Widget(tft, x, y, w, h, depth), head(0), pending(0), fullRedraw(true), maxVal(100) {
+    cap = (w > 2) ? (uint16_t)(w - 2) : 1;
+    data = new int16_t[cap];
+    for (uint16_t i = 0; i < cap; i++) data[i] = 0;
+
+    const uint16_t colours[] = { TFT_BLACK, TFT_DARKGREY, c, TFT_WHITE };
+    setPalette(colours, 4);
+    if (sprite != nullptr) {
+        sprite->setScrollRect(1, 1, w - 2, h - 2, ink(sprite, PAL_BG));
+    }
+}
+
+LidarGraph::~LidarGraph() {
+    delete[] data;
+}
+
+int16_t LidarGraph::sampleAt(uint16_t i) const {
+    uint16_t idx = head + i;
+    if (idx >= cap) idx -= cap;
+    return data[idx];
+}
+
+int LidarGraph::valueToY(int16_t v) const {
+    if (v < 0) v = 0;
+    if (v > (int16_t)maxVal) v = (int16_t)maxVal;
+    return (h - 2) - ((int)v * (h - 4)) / (int)maxVal;
 }
 
 void LidarGraph::addPoint(int val) {
-    data.push_back(val);
-    if (data.size() > (size_t)w) data.erase(data.begin());
-    dirty = true;
+    if (val < INT16_MIN) val = INT16_MIN;
+    if (val > INT16_MAX) val = INT16_MAX;
+
+    data[head] = (int16_t)val;
+    if (++head == cap) head = 0;
+    if (pending < cap) pending++;
+    invalidate();
 }
 
-void LidarGraph::draw() {
-    if (!dirty) return;
+void LidarGraph::drawLabel(TFT_eSprite* dst, int16_t ox, int16_t oy) {
+    dst->setTextDatum(TL_DATUM);
+    dst->setTextColor(ink(dst, PAL_TEXT));
+    dst->drawString("LIDAR", ox + 5, oy + 5, 1);
+}
 
-    sprite->fillSprite(TFT_BLACK);
-    sprite->drawRect(0, 0, w, h, TFT_DARKGREY);
-    sprite->drawLine(0, h / 2, w, h / 2, TFT_DARKGREY);
+void LidarGraph::render(TFT_eSprite* dst, int16_t ox, int16_t oy) {
+    uint16_t grid = ink(dst, PAL_GRID);
+    uint16_t trace = ink(dst, PAL_TRACE);
 
-    for (size_t i = 1; i < data.size(); i++) {
-        int y1 = map(data[i - 1], 0, maxVal, h - 2, 2);
-        int y2 = map(data[i], 0, maxVal, h - 2, 2);
-        sprite->drawLine((int)i - 1, y1, (int)i, y2, color);
+    dst->fillRect(ox, oy, w, h, ink(dst, PAL_BG));
+    dst->drawRect(ox, oy, w, h, grid);
+    dst->drawLine(ox, oy + h / 2, ox + w - 1, oy + h / 2, grid);
+
+    int prevY = valueToY(sampleAt(0));
+    for (uint16_t i = 1; i < cap; i++) {
+        int y2 = valueToY(sampleAt(i));
+        dst->drawLine(ox + i, oy + prevY, ox + i + 1, oy + y2, trace);
+        prevY = y2;
+    }
+
+    drawLabel(dst, ox, oy);
+}
+
+// Incremental path for the own-sprite case: the plot area already holds the
+// previous trace, so a draw is one scroll by the number of new samples plus
+// one line segment per sample at the right edge, instead of replotting every
+// column. Composited graphs have no persistent pixels and always render().
+void LidarGraph::draw() {
+    if (!dirty || sprite == nullptr) return;
+
+    if (fullRedraw || pending >= cap) {
+        render(sprite, 0, 0);
+        fullRedraw = false;
+        pending = 0;
+        return;
     }
 
-    sprite->setTextColor(TFT_WHITE);
-    sprite->drawString("LIDAR", 5, 5);
+    if (pending > 0) {
+        uint16_t trace = ink(sprite, PAL_TRACE);
+
+        sprite->scroll(-(int16_t)pending, 0);
+        sprite->drawFastHLine(cap - pending + 1, h / 2, pending, ink(sprite, PAL_GRID));
+        for (uint16_t i = cap - pending; i < cap; i++) {
+            sprite->drawLine(i, valueToY(sampleAt(i - 1)), i + 1, valueToY(sampleAt(i)), trace);
+        }
+        pending = 0;
+
+        // The label scrolls with the trace; wipe the smear and put it back.
+        sprite->fillRect(1, 5, 34, 8, ink(sprite, PAL_BG));
+        drawLabel(sprite, 0, 0);
+    }
 }
@@ -3,18 +3,30 @@
 
 #include <Arduino.h>
 #include <TFT_eSPI.h>
-#include <vector>
 #include "Widget.h"
 
 class LidarGraph : public Widget {
 private:
-    std::vector<int> data;
-    uint16_t color;
+    enum { PAL_BG, PAL_GRID, PAL_TRACE, PAL_TEXT };
+
+    // Fixed-capacity ring of the last `cap` samples, one per plot column.
+    // The ring is always full; `head` is the oldest sample.
+    int16_t* data;
+    uint16_t cap;
+    uint16_t head;
+    uint16_t pending;   // samples added since the last draw
+    bool fullRedraw;
     uint16_t maxVal;
 
+    int16_t sampleAt(uint16_t i) const;
+    int valueToY(int16_t v) const;
+    void drawLabel(TFT_eSprite* dst, int16_t ox, int16_t oy);
+
 public:
-    LidarGraph(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t c);
+    LidarGraph(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t c, uint8_t depth = 16);
+    ~LidarGraph();
     void addPoint(int val);
+    void render(TFT_eSprite* dst, int16_t ox, int16_t oy) override;
     void draw() override;
 };
 
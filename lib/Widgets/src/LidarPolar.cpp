@@ -1,52 +1,79 @@
 #include "LidarPolar.h"
 #include <math.h>
 
-int dpx;
-int dpy;
+// sin/cos of each whole degree in Q14, shared by every LidarPolar.
+static int16_t sinQ14[360];
+static int16_t cosQ14[360];
+static bool trigReady = false;
 
-LidarPolar::LidarPolar(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t c, uint16_t range)
-    : Widget(tft, x, y, w, h), maxRange(range), color(c) {
-    for (int i = 0; i < 360; i++) distances[i] = 0;
+static void buildTrigTables() {
+    if (trigReady) return;
+    for (int theta = 0; theta < 360; theta++) {
+        float rad = theta * (PI / 180.0);
+        sinQ14[theta] = (int16_t)lroundf(sinf(rad) * 16384.0f);
+        cosQ14[theta] = (int16_t)lroundf(cosf(rad) * 16384.0f);
+    }
+    trigReady = true;
+}
+
+LidarPolar::LidarPolar(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t c, uint16_t range, uint8_t depth)
+    : Widget(tft, x, y, w, h, depth), maxRange(range) {
+    const uint16_t colours[] = { TFT_BLACK, TFT_DARKGREY, c, TFT_WHITE };
+    setPalette(colours, 4);
+    buildTrigTables();
+    for (int i = 0; i < 360; i++) {
+        distances[i] = 0;
+        pointX[i] = 0;
+        pointY[i] = 0;
+    }
     cx = w / 2;
     cy = h / 2;
 }
 
+bool LidarPolar::visible(uint16_t angle) const {
+    uint16_t dist = distances[angle];
+    return dist > 0 && dist < maxRange;
+}
+
+void LidarPolar::invalidatePoint(uint16_t angle) {
+    if (visible(angle)) {
+        invalidate(cx + pointX[angle], cy + pointY[angle], 1, 1);
+    }
+}
+
+// 0 degrees points up, angles grow clockwise.
 void LidarPolar::updatePoint(uint16_t angle, uint16_t distance) {
     if (angle >= 360) return;
-    distances[angle] = distance;
-    dirty = true;
-}
+    if (distances[angle] == distance) return;
 
-void LidarPolar::draw() {
-    if (!dirty) return;
+    invalidatePoint(angle);
+    distances[angle] = distance;
 
-    sprite->fillSprite(TFT_BLACK);
-    sprite->drawCircle(cx, cy, w / 4, TFT_DARKGREY);
-    sprite->drawCircle(cx, cy, (w / 2) - 1, TFT_DARKGREY);
-    sprite->drawLine(cx, 0, cx, h, TFT_DARKGREY);
-    sprite->drawLine(0, cy, w, cy, TFT_DARKGREY);
+    int32_t r = ((int32_t)distance * (w / 2)) / maxRange;
+    pointX[angle] = (int16_t)((r * sinQ14[angle]) / 16384);
+    pointY[angle] = (int16_t)(-(r * cosQ14[angle]) / 16384);
+    invalidatePoint(angle);
+}
 
-    for (int theta = 0; theta < 360; theta++) 
-    {
-        uint16_t dist = distances[theta];
+void LidarPolar::render(TFT_eSprite* dst, int16_t ox, int16_t oy) {
+    uint16_t grid = ink(dst, PAL_GRID);
+    uint16_t point = ink(dst, PAL_POINT);
+    int16_t px0 = ox + cx;
+    int16_t py0 = oy + cy;
 
-        float r_pixel = (float)dist / maxRange * (w / 2);
-        float rad = theta * (PI / 180.0);
-        int px = cx + (r_pixel * cos(rad - PI / 2));
-        int py = cy + (r_pixel * sin(rad - PI / 2));
-        if (dist > 0 && dist < maxRange) 
-        {
-            sprite->drawPixel(px, py, color);
-        }
-        else
-        {
-            sprite->drawPixel(dpx, dpy, TFT_BLACK);
+    dst->fillRect(ox, oy, w, h, ink(dst, PAL_BG));
+    dst->drawCircle(px0, py0, w / 4, grid);
+    dst->drawCircle(px0, py0, (w / 2) - 1, grid);
+    dst->drawLine(px0, oy, px0, oy + h - 1, grid);
+    dst->drawLine(ox, py0, ox + w - 1, py0, grid);
 
+    for (uint16_t theta = 0; theta < 360; theta++) {
+        if (visible(theta)) {
+            dst->drawPixel(px0 + pointX[theta], py0 + pointY[theta], point);
         }
-        dpx = px;
-        dpy = py;
     }
 
-    sprite->setTextColor(TFT_WHITE);
-    sprite->drawString("RADAR", 5, 5);
+    dst->setTextDatum(TL_DATUM);
+    dst->setTextColor(ink(dst, PAL_TEXT));
+    dst->drawString("RADAR", ox + 5, oy + 5, 1);
 }
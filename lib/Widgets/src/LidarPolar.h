@@ -7,15 +7,23 @@
 
 class LidarPolar : public Widget {
 private:
+    enum { PAL_BG, PAL_GRID, PAL_POINT, PAL_TEXT };
+
     uint16_t distances[360];
+    // Pixel position of each point relative to the centre, kept up to date
+    // by updatePoint() so rendering (once per compositor tile) is a lookup.
+    int16_t pointX[360];
+    int16_t pointY[360];
     uint16_t maxRange;
-    uint16_t color;
     int cx, cy;
 
+    bool visible(uint16_t angle) const;
+    void invalidatePoint(uint16_t angle);
+
 public:
-    LidarPolar(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t c, uint16_t range);
+    LidarPolar(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t c, uint16_t range, uint8_t depth = 16);
     void updatePoint(uint16_t angle, uint16_t distance);
-    void draw() override;
+    void render(TFT_eSprite* dst, int16_t ox, int16_t oy) override;
 };
 
 #endif
@@ -1,24 +1,25 @@
 #include "ProxBar.h"
 
-ProxBar::ProxBar(TFT_eSPI* tft, int x, int y, int w, int h)
-    : Widget(tft, x, y, w, h) {}
+ProxBar::ProxBar(TFT_eSPI* tft, int x, int y, int w, int h, uint8_t depth)
+    : Widget(tft, x, y, w, h, depth) {
+    const uint16_t colours[] = { TFT_BLACK, TFT_WHITE, TFT_GREEN, TFT_YELLOW, TFT_RED };
+    setPalette(colours, 5);
+}
 
 void ProxBar::setValue(int v) {
     if (value != v) {
         value = v;
-        dirty = true;
+        invalidate();
     }
 }
 
-void ProxBar::draw() {
-    if (!dirty) return;
-
-    uint16_t barColor = TFT_GREEN;
-    if (value > 50) barColor = TFT_YELLOW;
-    if (value > 80) barColor = TFT_RED;
+void ProxBar::render(TFT_eSprite* dst, int16_t ox, int16_t oy) {
+    uint16_t barColor = ink(dst, PAL_LOW);
+    if (value > 50) barColor = ink(dst, PAL_MID);
+    if (value > 80) barColor = ink(dst, PAL_HIGH);
 
-    sprite->fillSprite(TFT_BLACK);
+    dst->fillRect(ox, oy, w, h, ink(dst, PAL_BG));
     int barH = map(value, 0, 100, 0, h);
-    sprite->fillRect(0, h - barH, w, barH, barColor);
-    sprite->drawRect(0, 0, w, h, TFT_WHITE);
+    dst->fillRect(ox, oy + h - barH, w, barH, barColor);
+    dst->drawRect(ox, oy, w, h, ink(dst, PAL_FRAME));
 }
@@ -7,12 +7,13 @@
 
 class ProxBar : public Widget {
 private:
+    enum { PAL_BG, PAL_FRAME, PAL_LOW, PAL_MID, PAL_HIGH };
     int value = 0;
 
 public:
-    ProxBar(TFT_eSPI* tft, int x, int y, int w, int h);
+    ProxBar(TFT_eSPI* tft, int x, int y, int w, int h, uint8_t depth = 16);
     void setValue(int v);
-    void draw() override;
+    void render(TFT_eSprite* dst, int16_t ox, int16_t oy) override;
 };
 
 #endif
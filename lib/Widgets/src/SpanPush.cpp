@@ -0,0 +1,103 @@
+#include "SpanPush.h"
+
+static inline uint16_t swap16(uint16_t c) {
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+// Stream pixels [x0, x1) of a sprite row into the open window. Sprite pixels
+// are stored byte-swapped, ready for the wire.
+static void streamRuns(TFT_eSPI* tft, const uint16_t* row, int32_t x0, int32_t x1) {
+    int32_t lit = x0;
+    int32_t i = x0;
+
+    while (i < x1) {
+        uint16_t c = row[i];
+        int32_t run = i + 1;
+        while (run < x1 && row[run] == c) run++;
+
+        if (run - i >= SPAN_PUSH_MIN_FILL) {
+            if (i > lit) tft->pushPixels(&row[lit], (uint32_t)(i - lit));
+            tft->pushBlock(swap16(c), (uint32_t)(run - i));
+            lit = run;
+        }
+        i = run;
+    }
+    if (x1 > lit) tft->pushPixels(&row[lit], (uint32_t)(x1 - lit));
+}
+
+void spanPush(TFT_eSPI* tft, TFT_eSprite* spr, int32_t x, int32_t y, uint16_t bg,
+              uint8_t* shadow, uint16_t shadowStride, SpanPushStats* stats) {
+    const uint16_t* img = (const uint16_t*)spr->getPointer();
+    int32_t sw = spr->width();
+    int32_t sh = spr->height();
+    int32_t w = sw;
+    int32_t h = sh;
+    uint16_t bgs = swap16(bg);
+    uint32_t windows = 0;
+    uint32_t pixels = 0;
+
+    if (img == nullptr || x < 0 || y < 0) return;
+    if (x + w > tft->width()) w = tft->width() - x;
+    if (y + h > tft->height()) h = tft->height() - y;
+    if (w <= 0 || h <= 0) return;
+
+    bool swap = tft->getSwapBytes();
+    tft->setSwapBytes(false);
+    tft->startWrite();
+
+    if (shadow == nullptr) {
+        tft->setWindow(x, y, x + w - 1, y + h - 1);
+        for (int32_t r = 0; r < h; r++) {
+            streamRuns(tft, img + r * sw, 0, w);
+        }
+        windows = 1;
+        pixels = (uint32_t)(w * h);
+    } else {
+        for (int32_t r = 0; r < h; r++) {
+            const uint16_t* row = img + r * sw;
+            uint8_t* bits = shadow + (size_t)r * shadowStride;
+            int32_t i = 0;
+
+            while (i < w) {
+                // Skip pixels the panel already shows as background.
+                while (i < w && row[i] == bgs && !(bits[i >> 3] & (1u << (i & 7)))) i++;
+                if (i >= w) break;
+
+                // Grow the window over pixels that must be sent, bridging
+                // background gaps too short to be worth a new window.
+                int32_t start = i;
+                int32_t end = i;
+                while (i < w) {
+                    if (row[i] != bgs || (bits[i >> 3] & (1u << (i & 7)))) {
+                        end = ++i;
+                        continue;
+                    }
+                    int32_t gap = i;
+                    while (i < w && row[i] == bgs && !(bits[i >> 3] & (1u << (i & 7)))) i++;
+                    if (i >= w || i - gap >= (int32_t)SPAN_PUSH_MIN_GAP) break;
+                }
+
+                tft->setWindow(x + start, y + r, x + end - 1, y + r);
+                streamRuns(tft, row, start, end);
+                windows++;
+                pixels += (uint32_t)(end - start);
+            }
+
+            for (int32_t b = 0; b < w; b++) {
+                if (row[b] != bgs) bits[b >> 3] |= (uint8_t)(1u << (b & 7));
+                else bits[b >> 3] &= (uint8_t)~(1u << (b & 7));
+            }
+        }
+    }
+
+    tft->endWrite();
+    tft->setSwapBytes(swap);
+
+    if (stats != nullptr) {
+        stats->pushes++;
+        stats->windows += windows;
+        stats->pixels += pixels;
+        stats->bytes += windows * SPAN_PUSH_WINDOW_BYTES + pixels * SPAN_PUSH_PIXEL_BYTES;
+        stats->fullBytes += SPAN_PUSH_WINDOW_BYTES + (uint32_t)(w * h) * SPAN_PUSH_PIXEL_BYTES;
+    }
+}
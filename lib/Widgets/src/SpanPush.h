@@ -0,0 +1,45 @@
+#ifndef SPAN_PUSH_H
+#define SPAN_PUSH_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+// Bytes per pixel on the wire: ILI9488 panels are driven in 18-bit colour.
+#if defined(ILI9488_DRIVER)
+#define SPAN_PUSH_PIXEL_BYTES 3u
+#else
+#define SPAN_PUSH_PIXEL_BYTES 2u
+#endif
+
+// Command and address bytes spent opening one address window
+// (CASET + 4, RASET + 4, RAMWR).
+#define SPAN_PUSH_WINDOW_BYTES 11u
+
+// Runs of one colour at least this long are sent with pushBlock() instead of
+// being read out of the sprite.
+#define SPAN_PUSH_MIN_FILL 8
+
+// Background gaps shorter than this are sent through rather than closing the
+// window: reopening one costs more than the skipped pixels.
+#define SPAN_PUSH_MIN_GAP ((SPAN_PUSH_WINDOW_BYTES + SPAN_PUSH_PIXEL_BYTES - 1u) / SPAN_PUSH_PIXEL_BYTES)
+
+struct SpanPushStats {
+    uint32_t pushes;
+    uint32_t windows;
+    uint32_t pixels;      // pixels actually sent
+    uint32_t bytes;       // estimated SPI bytes sent
+    uint32_t fullBytes;   // estimated SPI bytes for plain pushSprite()
+};
+
+// Push a 16-bit sprite to (x, y), row by row as runs.
+//
+// shadow, if given, holds one bit per destination pixel (bit x & 7 of byte
+// x / 8, rows `shadowStride` bytes apart) that is set when the panel may be
+// showing something other than `bg` there. Pixels that are `bg` in the sprite
+// and clear in the shadow are already correct on the panel and are skipped;
+// the shadow is updated to match what was pushed. Without a shadow every
+// pixel is sent through a single window.
+void spanPush(TFT_eSPI* tft, TFT_eSprite* spr, int32_t x, int32_t y, uint16_t bg,
+              uint8_t* shadow, uint16_t shadowStride, SpanPushStats* stats);
+
+#endif
@@ -0,0 +1,72 @@
+#include "TextPanel.h"
+
+#define TEXT_PANEL_MARGIN 4
+#define TEXT_PANEL_GLCD_W 6   // font 1 is fixed width
+
+// Cell height of the built-in TFT_eSPI fonts.
+static int16_t fontHeight(uint8_t font) {
+    switch (font) {
+        case 1:  return 8;
+        case 2:  return 16;
+        case 4:  return 26;
+        case 6:
+        case 7:  return 48;
+        case 8:  return 75;
+        default: return 8;
+    }
+}
+
+TextPanel::TextPanel(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t fg, uint16_t bg, uint8_t depth)
+    : Widget(tft, x, y, w, h, depth), lineCount(0) {
+    const uint16_t colours[] = { bg, fg };
+    setPalette(colours, 2);
+}
+
+uint8_t TextPanel::addLine(int16_t ty, uint8_t font) {
+    if (lineCount >= TEXT_PANEL_MAX_LINES) return TEXT_PANEL_MAX_LINES - 1;
+
+    Line& line = lines[lineCount];
+    line.text[0] = '\0';
+    line.ty = ty;
+    line.font = font;
+    return lineCount++;
+}
+
+void TextPanel::setText(uint8_t line, const char* text) {
+    if (line >= lineCount || text == nullptr) return;
+
+    Line& l = lines[line];
+    const size_t maxLen = sizeof(l.text) - 1;
+
+    size_t first = 0;
+    while (first < maxLen && l.text[first] != '\0' && l.text[first] == text[first]) first++;
+    if (first == maxLen || l.text[first] == text[first]) return;
+
+    size_t oldLen = first + strlen(l.text + first);
+    size_t newLen = first + strnlen(text + first, maxLen - first);
+    size_t end = (oldLen > newLen) ? oldLen : newLen;
+
+    // Same length: the text after the last difference has not moved.
+    if (oldLen == newLen) {
+        while (end > first && l.text[end - 1] == text[end - 1]) end--;
+    }
+
+    memcpy(l.text + first, text + first, newLen - first);
+    l.text[newLen] = '\0';
+
+    if (l.font == 1) {
+        invalidate(TEXT_PANEL_MARGIN + (int16_t)first * TEXT_PANEL_GLCD_W, l.ty,
+                   (int16_t)(end - first) * TEXT_PANEL_GLCD_W, fontHeight(l.font));
+    } else {
+        invalidate(0, l.ty, w, fontHeight(l.font));
+    }
+}
+
+void TextPanel::render(TFT_eSprite* dst, int16_t ox, int16_t oy) {
+    dst->fillRect(ox, oy, w, h, ink(dst, PAL_BG));
+    dst->setTextDatum(TL_DATUM);
+    dst->setTextColor(ink(dst, PAL_TEXT), ink(dst, PAL_BG));
+    for (uint8_t i = 0; i < lineCount; i++) {
+        dst->drawString(lines[i].text, ox + TEXT_PANEL_MARGIN, oy + lines[i].ty, lines[i].font);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef TEXT_PANEL_H
+#define TEXT_PANEL_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "Widget.h"
+
+#define TEXT_PANEL_MAX_LINES 4
+#define TEXT_PANEL_LINE_CHARS 96
+
+// A few lines of left-aligned text on a solid background. setText() keeps
+// the previous string and only invalidates the character cells that changed
+// (the rest of the line for proportional fonts).
+class TextPanel : public Widget {
+private:
+    enum { PAL_BG, PAL_TEXT };
+
+    struct Line {
+        char text[TEXT_PANEL_LINE_CHARS];
+        int16_t ty;
+        uint8_t font;
+    };
+
+    Line lines[TEXT_PANEL_MAX_LINES];
+    uint8_t lineCount;
+
+public:
+    TextPanel(TFT_eSPI* tft, int x, int y, int w, int h, uint16_t fg, uint16_t bg, uint8_t depth = 16);
+
+    // Adds a line at panel-relative y in a TFT_eSPI font; returns its index.
+    uint8_t addLine(int16_t ty, uint8_t font);
+    void setText(uint8_t line, const char* text);
+    void render(TFT_eSprite* dst, int16_t ox, int16_t oy) override;
+};
+
+#endif
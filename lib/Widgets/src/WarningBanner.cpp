@@ -0,0 +1,36 @@
+#include "WarningBanner.h"
+
+WarningBanner::WarningBanner(TFT_eSPI* tft, int x, int y, int w, int h, uint8_t depth)
+    : Widget(tft, x, y, w, h, depth), level(BANNER_QUIET) {
+    const uint16_t colours[] = { TFT_BLACK, TFT_YELLOW, TFT_ORANGE, TFT_RED, TFT_DARKGREY, TFT_BLACK, TFT_WHITE };
+    setPalette(colours, 7);
+    title[0] = '\0';
+    detail[0] = '\0';
+}
+
+void WarningBanner::setWarning(uint8_t _level, const char* _title, const char* _detail) {
+    if (_level > BANNER_DANGER) _level = BANNER_DANGER;
+    if (_level == level && strncmp(title, _title, sizeof(title)) == 0 &&
+        strncmp(detail, _detail, sizeof(detail)) == 0) {
+        return;
+    }
+    level = _level;
+    strncpy(title, _title, sizeof(title) - 1);
+    title[sizeof(title) - 1] = '\0';
+    strncpy(detail, _detail, sizeof(detail) - 1);
+    detail[sizeof(detail) - 1] = '\0';
+    invalidate();
+}
+
+void WarningBanner::render(TFT_eSprite* dst, int16_t ox, int16_t oy) {
+    static const uint8_t backgrounds[] = { PAL_BG, PAL_NOTICE, PAL_CAUTION, PAL_DANGER };
+    static const uint8_t inks[] = { PAL_QUIET_TEXT, PAL_DARK_TEXT, PAL_DARK_TEXT, PAL_LIGHT_TEXT };
+    uint8_t bg = backgrounds[level];
+    uint8_t fg = inks[level];
+
+    dst->fillRect(ox, oy, w, h, ink(dst, bg));
+    dst->setTextDatum(TC_DATUM);
+    dst->setTextColor(ink(dst, fg), ink(dst, bg));
+    dst->drawString(title, ox + w / 2, oy + 2, 2);
+    dst->drawString(detail, ox + w / 2, oy + h - 11, 1);
+}
@@ -0,0 +1,29 @@
+#ifndef WARNING_BANNER_H
+#define WARNING_BANNER_H
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+#include "Widget.h"
+
+#define WARNING_BANNER_CHARS 32
+
+// A title in font 2 over a detail line in font 1, on a background that
+// shows how serious things are: yellow, orange, red. Level 0 is the quiet
+// state.
+class WarningBanner : public Widget {
+private:
+    enum { PAL_BG, PAL_NOTICE, PAL_CAUTION, PAL_DANGER, PAL_QUIET_TEXT, PAL_DARK_TEXT, PAL_LIGHT_TEXT };
+
+    uint8_t level;
+    char title[WARNING_BANNER_CHARS];
+    char detail[WARNING_BANNER_CHARS];
+
+public:
+    enum { BANNER_QUIET = 0, BANNER_NOTICE, BANNER_CAUTION, BANNER_DANGER };
+
+    WarningBanner(TFT_eSPI* tft, int x, int y, int w, int h, uint8_t depth = 16);
+    void setWarning(uint8_t level, const char* title, const char* detail);
+    void render(TFT_eSprite* dst, int16_t ox, int16_t oy) override;
+};
+
+#endif
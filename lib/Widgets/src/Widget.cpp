@@ -1,21 +1,79 @@
 #include "Widget.h"
+#include "Compositor.h"
 
-Widget::Widget(TFT_eSPI* tft, int16_t _x, int16_t _y, uint16_t _w, uint16_t _h)
-    : x(_x), y(_y), w(_w), h(_h) {
-    sprite = new TFT_eSprite(tft);
-    sprite->setColorDepth(16);
-    sprite->createSprite(w, h);
+Widget::Widget(TFT_eSPI* tft, int16_t _x, int16_t _y, uint16_t _w, uint16_t _h, uint8_t _depth)
+    : sprite(nullptr), x(_x), y(_y), w(_w), h(_h), depth(_depth), paletteSize(0), compositor(nullptr) {
+    if (depth != 1 && depth != 4 && depth != 8) depth = 16;
+    if (tft != nullptr) {
+        sprite = new TFT_eSprite(tft);
+        sprite->setColorDepth(depth);
+        sprite->createSprite(w, h);
+    }
     dirty = true;
 }
 
 Widget::~Widget() {
-    sprite->deleteSprite();
-    delete sprite;
+    if (sprite != nullptr) {
+        sprite->deleteSprite();
+        delete sprite;
+    }
+}
+
+void Widget::draw() {
+    if (!dirty || sprite == nullptr) return;
+    render(sprite, 0, 0);
 }
 
 void Widget::push() {
-    if (dirty) {
+    if (dirty && sprite != nullptr) {
         sprite->pushSprite(x, y);
         dirty = false;
     }
 }
+
+size_t Widget::spriteBytes() const {
+    if (sprite == nullptr) return 0u;
+
+    switch (depth) {
+        case 1:  return (size_t)((w + 7) / 8) * h;
+        case 4:  return (size_t)((w + 1) / 2) * h;
+        case 8:  return (size_t)w * h;
+        default: return (size_t)w * h * 2u;
+    }
+}
+
+void Widget::setPalette(const uint16_t* colours, uint8_t count) {
+    if (count > WIDGET_MAX_PALETTE) count = WIDGET_MAX_PALETTE;
+    for (uint8_t i = 0; i < count; i++) palette[i] = colours[i];
+    paletteSize = count;
+
+    if (sprite == nullptr) return;
+    if (depth == 4) {
+        sprite->createPalette(palette, paletteSize);
+    } else if (depth == 1 && paletteSize >= 2) {
+        sprite->setBitmapColor(palette[1], palette[0]);
+    }
+}
+
+// Colour argument to pass to dst's drawing calls for a palette slot.
+// 4-bit sprites take the index itself; 1-bit sprites only know set/clear, so
+// every non-background slot renders in palette[1]. 8-bit sprites take RGB565
+// and quantise it to RGB332.
+uint16_t Widget::ink(TFT_eSprite* dst, uint8_t slot) const {
+    switch (dst->getColorDepth()) {
+        case 1:  return slot ? 1 : 0;
+        case 4:  return slot;
+        default: return (slot < paletteSize) ? palette[slot] : TFT_WHITE;
+    }
+}
+
+void Widget::invalidate() {
+    invalidate(0, 0, w, h);
+}
+
+void Widget::invalidate(int16_t rx, int16_t ry, int16_t rw, int16_t rh) {
+    dirty = true;
+    if (compositor != nullptr) {
+        compositor->invalidate(x + rx, y + ry, rw, rh);
+    }
+}
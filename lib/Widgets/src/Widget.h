@@ -4,17 +4,51 @@
 #include <Arduino.h>
 #include <TFT_eSPI.h>
 
+#define WIDGET_MAX_PALETTE 16
+
+class Compositor;
+
 class Widget {
 public:
-    TFT_eSprite* sprite;
+    TFT_eSprite* sprite;   // nullptr for widgets drawn through a Compositor
     int16_t x, y, w, h;
     bool dirty;
 
-    Widget(TFT_eSPI* tft, int16_t _x, int16_t _y, uint16_t _w, uint16_t _h);
+    // depth is the sprite colour depth: 16 (RGB565), 8 (RGB332), 4 (16-entry
+    // palette) or 1 (two colours). Below 16 bits the sprite is expanded to
+    // RGB565 by TFT_eSPI while it is pushed.
+    // With tft == nullptr no sprite is allocated and the widget can only be
+    // drawn by a Compositor.
+    Widget(TFT_eSPI* tft, int16_t _x, int16_t _y, uint16_t _w, uint16_t _h, uint8_t _depth = 16);
     virtual ~Widget();
 
-    virtual void draw() = 0;
+    // Draw the whole widget into dst with its top-left corner at (ox, oy).
+    // dst clips, so the widget may overhang it.
+    virtual void render(TFT_eSprite* dst, int16_t ox, int16_t oy) = 0;
+
+    // Own-sprite path: bring the sprite up to date, then push it.
+    virtual void draw();
     void push();
+
+    uint8_t colorDepth() const { return depth; }
+    size_t spriteBytes() const;
+
+protected:
+    uint8_t depth;
+    uint8_t paletteSize;
+    uint16_t palette[WIDGET_MAX_PALETTE];
+
+    // Widgets draw with palette slots; slot 0 is the background.
+    void setPalette(const uint16_t* colours, uint8_t count);
+    uint16_t ink(TFT_eSprite* dst, uint8_t slot) const;
+
+    // Mark the whole widget, or a widget-local rectangle, as changed.
+    void invalidate();
+    void invalidate(int16_t rx, int16_t ry, int16_t rw, int16_t rh);
+
+private:
+    friend class Compositor;
+    Compositor* compositor;
 };
 
 #endif
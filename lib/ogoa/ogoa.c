@@ -14,8 +14,10 @@ enum {
 static uint8_t frame_crc_fingerprint(const ogoa_frame_t *frame);
 static void emit_error(ogoa_ctx_t *ctx, ogoa_err_t err);
 static int send_raw(ogoa_ctx_t *ctx, const uint8_t *data, size_t len);
+static size_t tx_ring_used(const ogoa_ctx_t *ctx);
+static void complete_request(ogoa_ctx_t *ctx, ogoa_request_t *req, ogoa_req_state_t state, uint32_t now_ms);
 static int send_ack(ogoa_ctx_t *ctx, uint8_t seq);
-static int dispatch_frame(ogoa_ctx_t *ctx, const ogoa_frame_t *frame);
+static int dispatch_frame(ogoa_ctx_t *ctx, const ogoa_frame_t *frame, uint32_t now_ms);
 static uint8_t is_duplicate_non_ack(const ogoa_ctx_t *ctx, const ogoa_frame_t *frame);
 static void remember_non_ack(ogoa_ctx_t *ctx, const ogoa_frame_t *frame);
 
@@ -94,7 +96,7 @@ ogoa_err_t ogoa_send(ogoa_ctx_t *ctx, uint8_t type, const uint8_t *payload, uint
 
     sent = send_raw(ctx, ctx->tx_frame, frame_len);
     if (!sent) {
-        return OGOA_ERR_TX_FAILED;
+        return OGOA_ERR_TX_BUSY;
     }
 
     ctx->tx_len = frame_len;
@@ -115,6 +117,13 @@ void ogoa_tick(ogoa_ctx_t *ctx, uint32_t now_ms)
         return;
     }
 
+    (void)ogoa_tx_flush(ctx);
+
+    /* Ahead of the ACK wait, which returns early while frames keep going out. */
+    if (ctx->rsp_request != NULL && (now_ms - ctx->rsp_request->sent_ms) >= OGOA_RESPONSE_TIMEOUT_MS) {
+        complete_request(ctx, ctx->rsp_request, OGOA_REQ_TIMEOUT, now_ms);
+    }
+
     if (ctx->tx_waiting_ack) {
         elapsed = now_ms - ctx->tx_last_action_ms;
         if (elapsed < OGOA_ACK_TIMEOUT_MS) {
@@ -123,10 +132,11 @@ void ogoa_tick(ogoa_ctx_t *ctx, uint32_t now_ms)
 
         if (!ctx->tx_retried_once) {
             if (send_raw(ctx, ctx->tx_frame, ctx->tx_len)) {
+                ctx->stats.retransmits++;
                 ctx->tx_retried_once = 1u;
                 ctx->tx_last_action_ms = now_ms;
             } else {
-                emit_error(ctx, OGOA_ERR_TX_FAILED);
+                emit_error(ctx, OGOA_ERR_TX_BUSY);
             }
             return;
         }
@@ -134,6 +144,10 @@ void ogoa_tick(ogoa_ctx_t *ctx, uint32_t now_ms)
         ctx->tx_waiting_ack = 0u;
         ctx->tx_status_loop = 1u;
         ctx->tx_last_action_ms = now_ms;
+        ctx->stats.status_loops++;
+        if (ctx->tx_request != NULL) {
+            complete_request(ctx, ctx->tx_request, OGOA_REQ_TIMEOUT, now_ms);
+        }
     }
 
     if (ctx->tx_status_loop) {
@@ -146,12 +160,173 @@ void ogoa_tick(ogoa_ctx_t *ctx, uint32_t now_ms)
                 ctx->next_seq = (uint8_t)(ctx->next_seq + 1u);
                 ctx->tx_last_action_ms = now_ms;
             } else {
-                emit_error(ctx, OGOA_ERR_TX_FAILED);
+                emit_error(ctx, OGOA_ERR_TX_BUSY);
             }
         }
     }
 }
 
+size_t ogoa_tx_flush(ogoa_ctx_t *ctx)
+{
+    size_t total = 0u;
+    size_t used;
+    size_t offset;
+    size_t chunk;
+    int written;
+
+    if (ctx == NULL || ctx->ops.tx == NULL) {
+        return 0u;
+    }
+
+    /* At most two writes: up to the end of the buffer, then from its start. */
+    while ((used = tx_ring_used(ctx)) > 0u) {
+        offset = (size_t)(ctx->tx_ring_tail & (OGOA_TX_RING_BYTES - 1u));
+        chunk = OGOA_TX_RING_BYTES - offset;
+        if (chunk > used) {
+            chunk = used;
+        }
+
+        written = ctx->ops.tx(ctx->user_ctx, &ctx->tx_ring[offset], chunk);
+        if (written < 0) {
+            ctx->stats.tx_faults++;
+            emit_error(ctx, OGOA_ERR_TX_FAILED);
+            break;
+        }
+        if ((size_t)written > chunk) {
+            written = (int)chunk;
+        }
+        ctx->tx_ring_tail = (uint16_t)(ctx->tx_ring_tail + (uint16_t)written);
+        ctx->stats.tx_bytes += (uint32_t)written;
+        total += (size_t)written;
+        if ((size_t)written < chunk) {
+            break;
+        }
+    }
+    return total;
+}
+
+size_t ogoa_tx_pending(const ogoa_ctx_t *ctx)
+{
+    if (ctx == NULL) {
+        return 0u;
+    }
+    return tx_ring_used(ctx);
+}
+
+ogoa_err_t ogoa_send_request(ogoa_ctx_t *ctx, ogoa_request_t *req, uint8_t type, const uint8_t *payload,
+                             uint8_t len, uint32_t now_ms)
+{
+    uint8_t response_type;
+    ogoa_err_t err;
+
+    if (ctx == NULL || req == NULL || type == OGOA_TYPE_ACK) {
+        return OGOA_ERR_BAD_ARG;
+    }
+    response_type = ogoa_response_type(type);
+    if (response_type != 0u && ctx->rsp_request != NULL) {
+        return OGOA_ERR_TX_FAILED;
+    }
+
+    err = ogoa_send(ctx, type, payload, len, now_ms);
+    if (err != OGOA_OK) {
+        return err;
+    }
+
+    req->state = OGOA_REQ_PENDING;
+    req->seq = ctx->tx_pending_seq;
+    req->type = type;
+    req->response_type = response_type;
+    req->sent_ms = now_ms;
+    req->done_ms = 0u;
+    ctx->tx_request = req;
+    if (response_type != 0u) {
+        ctx->rsp_request = req;
+    }
+    return OGOA_OK;
+}
+
+void ogoa_request_cancel(ogoa_ctx_t *ctx, ogoa_request_t *req)
+{
+    if (ctx == NULL || req == NULL) {
+        return;
+    }
+    if (ctx->tx_request == req) {
+        ctx->tx_request = NULL;
+    }
+    if (ctx->rsp_request == req) {
+        ctx->rsp_request = NULL;
+    }
+}
+
+uint8_t ogoa_response_type(uint8_t request_type)
+{
+    switch (request_type) {
+    case OGOA_TYPE_STATUS_REQUEST:
+        return OGOA_TYPE_STATUS_RESPONSE;
+    case OGOA_TYPE_STATS_REQUEST:
+        return OGOA_TYPE_STATS_RESPONSE;
+    default:
+        return 0u;
+    }
+}
+
+ogoa_tx_state_t ogoa_tx_state(const ogoa_ctx_t *ctx)
+{
+    if (ctx == NULL) {
+        return OGOA_TX_IDLE;
+    }
+    if (ctx->tx_status_loop) {
+        return OGOA_TX_STATUS_LOOP;
+    }
+    if (ctx->tx_waiting_ack) {
+        return ctx->tx_retried_once ? OGOA_TX_WAIT_ACK_RETRIED : OGOA_TX_WAIT_ACK;
+    }
+    if (ctx->rsp_request != NULL) {
+        return OGOA_TX_WAIT_RESPONSE;
+    }
+    return OGOA_TX_IDLE;
+}
+
+void ogoa_stats_snapshot(const ogoa_ctx_t *ctx, ogoa_stats_t *out)
+{
+    if (ctx == NULL || out == NULL) {
+        return;
+    }
+    *out = ctx->stats;
+}
+
+uint8_t ogoa_stats_encode(const ogoa_stats_t *stats, uint8_t *payload)
+{
+    const uint32_t *fields = (const uint32_t *)(const void *)stats;
+    size_t i;
+
+    if (stats == NULL || payload == NULL) {
+        return 0u;
+    }
+    for (i = 0u; i < OGOA_STATS_FIELDS; ++i) {
+        payload[4u * i] = (uint8_t)fields[i];
+        payload[4u * i + 1u] = (uint8_t)(fields[i] >> 8);
+        payload[4u * i + 2u] = (uint8_t)(fields[i] >> 16);
+        payload[4u * i + 3u] = (uint8_t)(fields[i] >> 24);
+    }
+    return (uint8_t)OGOA_STATS_PAYLOAD_BYTES;
+}
+
+int ogoa_stats_decode(const uint8_t *payload, uint8_t len, ogoa_stats_t *out)
+{
+    uint32_t *fields = (uint32_t *)(void *)out;
+    size_t i;
+
+    if (payload == NULL || out == NULL || len < OGOA_STATS_PAYLOAD_BYTES) {
+        return 0;
+    }
+    for (i = 0u; i < OGOA_STATS_FIELDS; ++i) {
+        fields[i] = (uint32_t)payload[4u * i] | ((uint32_t)payload[4u * i + 1u] << 8) |
+                    ((uint32_t)payload[4u * i + 2u] << 16) | ((uint32_t)payload[4u * i + 3u] << 24);
+    }
+    return 1;
+}
+
 void ogoa_process_byte(ogoa_ctx_t *ctx, uint8_t byte, uint32_t now_ms)
 {
     ogoa_frame_t frame;
@@ -163,6 +338,7 @@ void ogoa_process_byte(ogoa_ctx_t *ctx, uint8_t byte, uint32_t now_ms)
         return;
     }
 
+    ctx->stats.rx_bytes++;
     switch (ctx->rx_state) {
     case RX_WAIT_START:
         if (byte == OGOA_START_BYTE) {
@@ -188,6 +364,7 @@ void ogoa_process_byte(ogoa_ctx_t *ctx, uint8_t byte, uint32_t now_ms)
         if (ctx->rx_expected_payload_len > OGOA_MAX_PAYLOAD) {
             ctx->rx_state = RX_WAIT_START;
             ctx->rx_index = 0u;
+            ctx->stats.oversize_lengths++;
             emit_error(ctx, OGOA_ERR_PAYLOAD_TOO_LARGE);
         } else if (ctx->rx_expected_payload_len == 0u) {
             ctx->rx_state = RX_WAIT_CHECKSUM;
@@ -204,11 +381,13 @@ void ogoa_process_byte(ogoa_ctx_t *ctx, uint8_t byte, uint32_t now_ms)
         break;
 
     case RX_WAIT_CHECKSUM:
-        ctx->rx_buf[ctx->rx_index++] = byte;
-        expected_crc = ogoa_calc_checksum(ctx->rx_buf, (size_t)ctx->rx_index - 1u);
-        received_crc = ctx->rx_buf[ctx->rx_index - 1u];
+        /* A full frame is 256 bytes, one past what rx_index can count. */
+        expected_crc = ogoa_calc_checksum(ctx->rx_buf, OGOA_HEADER_BYTES + (size_t)ctx->rx_expected_payload_len);
+        received_crc = byte;
+        ctx->rx_buf[OGOA_HEADER_BYTES + ctx->rx_expected_payload_len] = byte;
 
         if (expected_crc == received_crc) {
+            ctx->stats.rx_frames++;
             frame.seq = ctx->rx_buf[1];
             frame.type = ctx->rx_buf[2];
             frame.len = ctx->rx_buf[3];
@@ -220,23 +399,39 @@ void ogoa_process_byte(ogoa_ctx_t *ctx, uint8_t byte, uint32_t now_ms)
                 if (ctx->tx_waiting_ack && frame.seq == ctx->tx_pending_seq) {
                     ctx->tx_waiting_ack = 0u;
                     ctx->tx_retried_once = 0u;
+                    if (ctx->tx_request != NULL) {
+                        if (ctx->tx_request->response_type == 0u) {
+                            complete_request(ctx, ctx->tx_request, OGOA_REQ_ACKED, now_ms);
+                        } else {
+                            ctx->tx_request = NULL;
+                        }
+                    }
                 }
             } else {
                 if (send_ack(ctx, frame.seq)) {
                     duplicate = is_duplicate_non_ack(ctx, &frame);
                     if (!duplicate) {
                         remember_non_ack(ctx, &frame);
-                        dispatch_frame(ctx, &frame);
+                        dispatch_frame(ctx, &frame, now_ms);
+                    } else {
+                        ctx->stats.duplicates++;
                     }
                     if (ctx->tx_status_loop && frame.type == OGOA_TYPE_STATUS_RESPONSE) {
                         ctx->tx_status_loop = 0u;
                     }
                     ctx->tx_last_action_ms = now_ms;
+                    if (!duplicate && ctx->rsp_request != NULL && frame.type == ctx->rsp_request->response_type) {
+                        if (ctx->rsp_request->response != NULL) {
+                            *ctx->rsp_request->response = frame;
+                        }
+                        complete_request(ctx, ctx->rsp_request, OGOA_REQ_RESPONDED, now_ms);
+                    }
                 } else {
-                    emit_error(ctx, OGOA_ERR_TX_FAILED);
+                    emit_error(ctx, OGOA_ERR_TX_BUSY);
                 }
             }
         } else {
+            ctx->stats.checksum_errors++;
             emit_error(ctx, OGOA_ERR_CHECKSUM);
         }
 
@@ -270,12 +465,44 @@ static void emit_error(ogoa_ctx_t *ctx, ogoa_err_t err)
     }
 }
 
+static size_t tx_ring_used(const ogoa_ctx_t *ctx)
+{
+    return (size_t)(uint16_t)(ctx->tx_ring_head - ctx->tx_ring_tail);
+}
+
+/* Queues the whole frame, or nothing if the ring has no room for it even
+   after a drain, then hands the transport whatever it will take now. */
 static int send_raw(ogoa_ctx_t *ctx, const uint8_t *data, size_t len)
 {
-    int written;
+    size_t used;
+    size_t offset;
+    size_t first;
+
+    used = tx_ring_used(ctx);
+    if (len > OGOA_TX_RING_BYTES - used) {
+        (void)ogoa_tx_flush(ctx);
+        used = tx_ring_used(ctx);
+        if (len > OGOA_TX_RING_BYTES - used) {
+            ctx->stats.tx_busy++;
+            return 0;
+        }
+    }
+
+    offset = (size_t)(ctx->tx_ring_head & (OGOA_TX_RING_BYTES - 1u));
+    first = OGOA_TX_RING_BYTES - offset;
+    if (first > len) {
+        first = len;
+    }
+    memcpy(&ctx->tx_ring[offset], data, first);
+    memcpy(ctx->tx_ring, data + first, len - first);
+    ctx->tx_ring_head = (uint16_t)(ctx->tx_ring_head + (uint16_t)len);
+    ctx->stats.tx_frames++;
+    if (used + len > ctx->tx_ring_peak) {
+        ctx->tx_ring_peak = (uint16_t)(used + len);
+    }
 
-    written = ctx->ops.tx(ctx->user_ctx, data, len);
-    return written == (int)len;
+    (void)ogoa_tx_flush(ctx);
+    return 1;
 }
 
 static int send_ack(ogoa_ctx_t *ctx, uint8_t seq)
@@ -290,8 +517,28 @@ static int send_ack(ogoa_ctx_t *ctx, uint8_t seq)
     return send_raw(ctx, frame, len);
 }
 
-static int dispatch_frame(ogoa_ctx_t *ctx, const ogoa_frame_t *frame)
+/* Detached before done runs, so done may send the next request. */
+static void complete_request(ogoa_ctx_t *ctx, ogoa_request_t *req, ogoa_req_state_t state, uint32_t now_ms)
+{
+    ogoa_request_cancel(ctx, req);
+    req->state = state;
+    req->done_ms = now_ms;
+    if (req->done != NULL) {
+        req->done(req->user_ctx, req);
+    }
+}
+
+static int dispatch_frame(ogoa_ctx_t *ctx, const ogoa_frame_t *frame, uint32_t now_ms)
 {
+    ogoa_stats_t stats;
+    uint8_t payload[OGOA_STATS_PAYLOAD_BYTES];
+
+    if (frame->type == OGOA_TYPE_STATS_REQUEST) {
+        /* Refused while this end awaits an ACK; the peer's request times out. */
+        stats = ctx->stats;
+        (void)ogoa_send(ctx, OGOA_TYPE_STATS_RESPONSE, payload, ogoa_stats_encode(&stats, payload), now_ms);
+        return 1;
+    }
     if (ctx->ops.on_frame != NULL) {
         ctx->ops.on_frame(ctx->user_ctx, frame);
     }
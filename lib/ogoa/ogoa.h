@@ -26,16 +26,35 @@ extern "C" {
 #define OGOA_TYPE_STATUS_RESPONSE 0xB4u
 #define OGOA_TYPE_ACK 0x67u
 #define OGOA_TYPE_LIDAR_SEND 0xAAu
+#define OGOA_TYPE_LIDAR_SCAN 0xABu
+#define OGOA_TYPE_WARNING 0x57u
+#define OGOA_TYPE_STATS_REQUEST 0x53u
+#define OGOA_TYPE_STATS_RESPONSE 0x35u
 
 #define OGOA_ACK_TIMEOUT_MS 100u
 #define OGOA_STATUS_LOOP_INTERVAL_MS 250u
+/* A request that expects a response gives up this long after it was sent;
+   longer than an ACK timeout and its retry. */
+#define OGOA_RESPONSE_TIMEOUT_MS 500u
+
+/* Transmit ring: whole frames wait here until the transport takes them.
+   Must be a power of two and hold at least one frame of the largest size. */
+#ifndef OGOA_TX_RING_BYTES
+#define OGOA_TX_RING_BYTES 512u
+#endif
+
+#if (OGOA_TX_RING_BYTES & (OGOA_TX_RING_BYTES - 1u)) != 0u || OGOA_TX_RING_BYTES < OGOA_FRAME_MAX_BYTES || OGOA_TX_RING_BYTES > 32768u
+#error "OGOA_TX_RING_BYTES must be a power of two from OGOA_FRAME_MAX_BYTES to 32768"
+#endif
 
 typedef enum {
     OGOA_OK = 0,
     OGOA_ERR_BAD_ARG = -1,
     OGOA_ERR_PAYLOAD_TOO_LARGE = -2,
     OGOA_ERR_TX_FAILED = -3,
-    OGOA_ERR_CHECKSUM = -4
+    OGOA_ERR_CHECKSUM = -4,
+    OGOA_ERR_BAD_CAPTURE = -5,
+    OGOA_ERR_TX_BUSY = -6
 } ogoa_err_t;
 
 typedef struct {
@@ -45,6 +64,8 @@ typedef struct {
     uint8_t payload[OGOA_MAX_PAYLOAD];
 } ogoa_frame_t;
 
+/* Writes what the transport can take right now without blocking, possibly
+   nothing, and returns that count; a negative return is a transport fault. */
 typedef int (*ogoa_tx_fn)(void *user_ctx, const uint8_t *data, size_t len);
 typedef void (*ogoa_rx_fn)(void *user_ctx, const ogoa_frame_t *frame);
 typedef void (*ogoa_error_fn)(void *user_ctx, ogoa_err_t err);
@@ -55,6 +76,63 @@ typedef struct {
     ogoa_error_fn on_error;
 } ogoa_ops_t;
 
+/* Outcome of a request (ogoa_send_request). */
+typedef enum {
+    OGOA_REQ_PENDING = 0,
+    OGOA_REQ_ACKED = 1,         /* delivered; no response expected */
+    OGOA_REQ_RESPONDED = 2,     /* the correlated response arrived */
+    OGOA_REQ_TIMEOUT = 3        /* no ACK after the retry, or no response in time */
+} ogoa_req_state_t;
+
+typedef struct ogoa_request ogoa_request_t;
+typedef void (*ogoa_done_fn)(void *user_ctx, ogoa_request_t *req);
+
+/* A frame in flight, in storage the caller owns until it completes. The
+   caller sets done, user_ctx and response (all optional); done runs once,
+   from ogoa_process_byte or ogoa_tick, when state leaves OGOA_REQ_PENDING. */
+struct ogoa_request {
+    ogoa_done_fn done;
+    void *user_ctx;
+    ogoa_frame_t *response;     /* filled in on OGOA_REQ_RESPONDED */
+
+    ogoa_req_state_t state;
+    uint8_t seq;
+    uint8_t type;
+    uint8_t response_type;      /* 0 if the ACK completes it */
+    uint32_t sent_ms;
+    uint32_t done_ms;
+};
+
+/* Link counters, from ogoa_init on; they wrap at 2^32. Only the calls on
+   the context write them, with plain increments, so a copy taken between
+   those calls (ogoa_stats_snapshot) is consistent. The fields are in the
+   order of the Stats Response payload, one little-endian uint32 each. */
+typedef struct {
+    uint32_t rx_bytes;
+    uint32_t tx_bytes;          /* taken by the transport */
+    uint32_t rx_frames;         /* valid, ACKs included */
+    uint32_t tx_frames;         /* queued, ACKs and retries included */
+    uint32_t checksum_errors;
+    uint32_t oversize_lengths;  /* length byte over OGOA_MAX_PAYLOAD */
+    uint32_t retransmits;       /* after an ACK timeout */
+    uint32_t status_loops;      /* entries into the status loop */
+    uint32_t duplicates;        /* repeated frames ACKed but not passed on */
+    uint32_t tx_busy;           /* frames refused for want of ring space */
+    uint32_t tx_faults;         /* negative returns from the transport */
+} ogoa_stats_t;
+
+#define OGOA_STATS_FIELDS (sizeof(ogoa_stats_t) / sizeof(uint32_t))
+#define OGOA_STATS_PAYLOAD_BYTES (OGOA_STATS_FIELDS * 4u)
+
+/* Where the sending side is, for display. */
+typedef enum {
+    OGOA_TX_IDLE = 0,
+    OGOA_TX_WAIT_ACK = 1,
+    OGOA_TX_WAIT_ACK_RETRIED = 2,
+    OGOA_TX_WAIT_RESPONSE = 3,  /* ACKed, a request awaits its response */
+    OGOA_TX_STATUS_LOOP = 4
+} ogoa_tx_state_t;
+
 typedef struct {
     ogoa_ops_t ops;
     void *user_ctx;
@@ -69,6 +147,14 @@ typedef struct {
     uint8_t tx_status_loop;
     uint32_t tx_last_action_ms;
 
+    uint8_t tx_ring[OGOA_TX_RING_BYTES];
+    uint16_t tx_ring_head;
+    uint16_t tx_ring_tail;
+    uint16_t tx_ring_peak;
+
+    ogoa_request_t *tx_request;     /* awaiting the ACK */
+    ogoa_request_t *rsp_request;    /* awaiting its response */
+
     uint8_t rx_buf[OGOA_FRAME_MAX_BYTES];
     uint8_t rx_index;
     uint8_t rx_expected_payload_len;
@@ -79,6 +165,8 @@ typedef struct {
     uint8_t last_non_ack_type;
     uint8_t last_non_ack_len;
     uint8_t last_non_ack_crc;
+
+    ogoa_stats_t stats;
 } ogoa_ctx_t;
 
 void ogoa_init(ogoa_ctx_t *ctx, const ogoa_ops_t *ops, void *user_ctx);
@@ -87,6 +175,38 @@ ogoa_err_t ogoa_send(ogoa_ctx_t *ctx, uint8_t type, const uint8_t *payload, uint
 void ogoa_process_byte(ogoa_ctx_t *ctx, uint8_t byte, uint32_t now_ms);
 void ogoa_tick(ogoa_ctx_t *ctx, uint32_t now_ms);
 
+/* Frames are queued whole in the transmit ring, or not at all: ogoa_send
+   returns OGOA_ERR_TX_BUSY when the ring has no room for the frame, and a
+   received frame that cannot queue its ACK is dropped so the peer retries.
+   Queueing a frame drains what the transport takes at once, and ogoa_tick
+   drains the rest. A transport with a TX-empty interrupt may also call
+   ogoa_tx_flush from it, provided the interrupt is masked around the other
+   calls on the context. ogoa_tx_flush returns the bytes written. */
+size_t ogoa_tx_flush(ogoa_ctx_t *ctx);
+size_t ogoa_tx_pending(const ogoa_ctx_t *ctx);
+
+/* ogoa_send, with req tracking the frame to its ACK or, for a type that has
+   a response (ogoa_response_type), to that response. One request may await
+   a response at a time; OGOA_ERR_TX_FAILED otherwise, as while a frame
+   awaits its ACK. On an error req is left untouched and never completes. */
+ogoa_err_t ogoa_send_request(ogoa_ctx_t *ctx, ogoa_request_t *req, uint8_t type, const uint8_t *payload,
+                             uint8_t len, uint32_t now_ms);
+/* Forgets req without completing it, e.g. before its storage goes away. */
+void ogoa_request_cancel(ogoa_ctx_t *ctx, ogoa_request_t *req);
+/* The frame type that answers request_type, or 0 if only the ACK does. */
+uint8_t ogoa_response_type(uint8_t request_type);
+
+ogoa_tx_state_t ogoa_tx_state(const ogoa_ctx_t *ctx);
+
+void ogoa_stats_snapshot(const ogoa_ctx_t *ctx, ogoa_stats_t *out);
+/* A Stats Request (0x53) is answered by the context itself with a Stats
+   Response (0x35) and not passed to on_frame; send one with
+   ogoa_send_request to read the peer's counters. These convert the payload;
+   decode takes a longer payload from a newer peer and returns 0 if it is
+   too short. */
+uint8_t ogoa_stats_encode(const ogoa_stats_t *stats, uint8_t *payload);
+int ogoa_stats_decode(const uint8_t *payload, uint8_t len, ogoa_stats_t *out);
+
 size_t ogoa_build_frame_bytes(uint8_t seq, uint8_t type, const uint8_t *payload, uint8_t len, uint8_t *out_frame);
 uint8_t ogoa_calc_checksum(const uint8_t *frame_without_checksum, size_t len_without_checksum);
 
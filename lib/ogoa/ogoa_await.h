@@ -0,0 +1,89 @@
+#ifndef OGOA_AWAIT_H
+#define OGOA_AWAIT_H
+
+#include <stdint.h>
+
+#if __cplusplus < 202002L
+#error "ogoa_await.h needs C++20 coroutines; build with -std=gnu++20"
+#endif
+
+#include <coroutine>
+
+#include "ogoa.h"
+#include "ogoa_msg.h"
+
+// ogoa_send_request as a C++20 awaitable, for host tools.
+//
+//   ogoa::Outcome r = co_await ogoa::Request(&ctx, ogoa::StatusRequest{}, nowMs, &response);
+//   if (r.state == OGOA_REQ_RESPONDED) ...
+//
+// The frame goes out when the Request is made. The coroutine resumes from
+// inside ogoa_process_byte or ogoa_tick when the request completes, or at
+// once if it could not be sent (Outcome::error). The Request holds the
+// ogoa_request_t, so it must stay put until then; a temporary in the
+// co_await expression does.
+
+namespace ogoa {
+
+struct Outcome {
+    ogoa_err_t error;        // from ogoa_send_request
+    ogoa_req_state_t state;  // OGOA_REQ_PENDING if error is set
+
+    bool ok() const { return error == OGOA_OK && state != OGOA_REQ_TIMEOUT; }
+};
+
+class Request {
+public:
+    Request(ogoa_ctx_t* ctx, uint8_t type, const uint8_t* payload, uint8_t len, uint32_t nowMs,
+            ogoa_frame_t* response = nullptr)
+        : ctx_(ctx) {
+        start(type, payload, len, nowMs, response);
+    }
+
+    template <typename M>
+    Request(ogoa_ctx_t* ctx, const M& msg, uint32_t nowMs, ogoa_frame_t* response = nullptr) : ctx_(ctx) {
+        uint8_t payload[OGOA_MAX_PAYLOAD];
+        uint8_t len = encode(msg, payload);
+        start(M::type, len > 0u ? payload : nullptr, len, nowMs, response);
+    }
+
+    Request(const Request&) = delete;
+    Request& operator=(const Request&) = delete;
+
+    ~Request() {
+        if (error_ == OGOA_OK && req_.state == OGOA_REQ_PENDING) {
+            ogoa_request_cancel(ctx_, &req_);
+        }
+    }
+
+    bool await_ready() const { return error_ != OGOA_OK || req_.state != OGOA_REQ_PENDING; }
+    void await_suspend(std::coroutine_handle<> waiter) { waiter_ = waiter; }
+    Outcome await_resume() const { return Outcome{ error_, req_.state }; }
+
+    const ogoa_request_t& request() const { return req_; }
+
+private:
+    void start(uint8_t type, const uint8_t* payload, uint8_t len, uint32_t nowMs, ogoa_frame_t* response) {
+        req_.done = onDone;
+        req_.user_ctx = this;
+        req_.response = response;
+        req_.state = OGOA_REQ_PENDING;
+        error_ = ogoa_send_request(ctx_, &req_, type, payload, len, nowMs);
+    }
+
+    static void onDone(void* self, ogoa_request_t*) {
+        std::coroutine_handle<> waiter = static_cast<Request*>(self)->waiter_;
+        if (waiter) {
+            waiter.resume();
+        }
+    }
+
+    ogoa_ctx_t* ctx_;
+    ogoa_request_t req_ = {};
+    ogoa_err_t error_ = OGOA_OK;
+    std::coroutine_handle<> waiter_;
+};
+
+}  // namespace ogoa
+
+#endif
@@ -0,0 +1,123 @@
+#include "ogoa_capture.h"
+
+#include <string.h>
+
+static size_t put_leb128(uint32_t v, uint8_t *out);
+static int get_leb128(const uint8_t *data, size_t len, size_t *pos, uint32_t *out);
+
+size_t ogoa_capture_header(uint32_t start_unix_s, uint8_t *out)
+{
+    if (out == NULL) {
+        return 0u;
+    }
+
+    memset(out, 0, OGOA_CAPTURE_HEADER_BYTES);
+    memcpy(out, OGOA_CAPTURE_MAGIC, 4u);
+    out[4] = (uint8_t)OGOA_CAPTURE_VERSION;
+    out[12] = (uint8_t)(start_unix_s & 0xFFu);
+    out[13] = (uint8_t)((start_unix_s >> 8) & 0xFFu);
+    out[14] = (uint8_t)((start_unix_s >> 16) & 0xFFu);
+    out[15] = (uint8_t)((start_unix_s >> 24) & 0xFFu);
+    return OGOA_CAPTURE_HEADER_BYTES;
+}
+
+size_t ogoa_capture_record(ogoa_capture_writer_t *w, uint8_t dir, uint32_t now_us,
+                           const uint8_t *data, size_t len, uint8_t *out)
+{
+    uint32_t delta;
+    size_t n;
+
+    if (w == NULL || data == NULL || out == NULL || len == 0u || len > OGOA_CAPTURE_CHUNK_MAX) {
+        return 0u;
+    }
+
+    delta = w->started ? (uint32_t)(now_us - w->last_us) : 0u;
+    w->last_us = now_us;
+    w->started = 1u;
+
+    out[0] = (uint8_t)(((dir & 1u) << 7) | (uint8_t)(len - 1u));
+    n = 1u + put_leb128(delta, &out[1]);
+    memcpy(&out[n], data, len);
+    return n + len;
+}
+
+ogoa_err_t ogoa_capture_open(ogoa_capture_reader_t *r, const uint8_t *data, size_t len)
+{
+    if (r == NULL || data == NULL) {
+        return OGOA_ERR_BAD_ARG;
+    }
+    if (len < OGOA_CAPTURE_HEADER_BYTES || memcmp(data, OGOA_CAPTURE_MAGIC, 4u) != 0 ||
+        data[4] != OGOA_CAPTURE_VERSION) {
+        return OGOA_ERR_BAD_CAPTURE;
+    }
+
+    r->data = data;
+    r->len = len;
+    r->pos = OGOA_CAPTURE_HEADER_BYTES;
+    r->t_us = 0u;
+    r->start_unix_s = (uint32_t)data[12] | ((uint32_t)data[13] << 8) |
+                      ((uint32_t)data[14] << 16) | ((uint32_t)data[15] << 24);
+    return OGOA_OK;
+}
+
+int ogoa_capture_next(ogoa_capture_reader_t *r, ogoa_capture_record_t *rec)
+{
+    size_t pos;
+    uint32_t delta;
+    uint8_t tag;
+    uint8_t len;
+
+    if (r == NULL || rec == NULL) {
+        return OGOA_ERR_BAD_ARG;
+    }
+    if (r->pos >= r->len) {
+        return 0;
+    }
+
+    pos = r->pos;
+    tag = r->data[pos++];
+    if (!get_leb128(r->data, r->len, &pos, &delta)) {
+        return OGOA_ERR_BAD_CAPTURE;
+    }
+    len = (uint8_t)((tag & 0x7Fu) + 1u);
+    if (r->len - pos < len) {
+        return OGOA_ERR_BAD_CAPTURE;
+    }
+
+    r->t_us += delta;
+    rec->dir = (uint8_t)(tag >> 7);
+    rec->t_us = r->t_us;
+    rec->bytes = &r->data[pos];
+    rec->len = len;
+    r->pos = pos + len;
+    return 1;
+}
+
+static size_t put_leb128(uint32_t v, uint8_t *out)
+{
+    size_t n = 0u;
+
+    while (v >= 0x80u) {
+        out[n++] = (uint8_t)(v | 0x80u);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+static int get_leb128(const uint8_t *data, size_t len, size_t *pos, uint32_t *out)
+{
+    uint32_t v = 0u;
+    unsigned shift = 0u;
+
+    while (*pos < len && shift < 35u) {
+        uint8_t b = data[(*pos)++];
+        v |= (uint32_t)(b & 0x7Fu) << shift;
+        if ((b & 0x80u) == 0u) {
+            *out = v;
+            return 1;
+        }
+        shift += 7u;
+    }
+    return 0;
+}
@@ -0,0 +1,74 @@
+#ifndef OGOA_CAPTURE_H
+#define OGOA_CAPTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ogoa.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ Capture of the raw bytes on an OGOA link, for replaying field sessions.
+
+ File header (16 bytes, little endian):
+ +--------+-------+-------+----------+----------+------------+
+ | "OGCP" |  Ver  | Flags | Reserved | Reserved | Start time |
+ |   4    |   1   |   1   |    2     |    4     |  4 (unix s)|
+ +--------+-------+-------+----------+----------+------------+
+
+ Then records until the end of the file:
+ +-----+-------------+---------------+
+ | Tag | Delta (us)  |     Bytes     |
+ |  1  | LEB128, 1-5 | (Tag & 0x7F)+1|
+ +-----+-------------+---------------+
+ Tag bit 7 is the direction (0 = received, 1 = transmitted). Delta is the
+ time since the previous record, or since capture start for the first one.
+*/
+
+#define OGOA_CAPTURE_MAGIC "OGCP"
+#define OGOA_CAPTURE_VERSION 1u
+#define OGOA_CAPTURE_HEADER_BYTES 16u
+#define OGOA_CAPTURE_CHUNK_MAX 128u
+#define OGOA_CAPTURE_RECORD_MAX (1u + 5u + OGOA_CAPTURE_CHUNK_MAX)
+
+#define OGOA_CAPTURE_RX 0u
+#define OGOA_CAPTURE_TX 1u
+
+typedef struct {
+    uint32_t last_us;
+    uint8_t started;
+} ogoa_capture_writer_t;
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+    size_t pos;
+    uint64_t t_us;
+    uint32_t start_unix_s;
+} ogoa_capture_reader_t;
+
+typedef struct {
+    uint8_t dir;
+    uint64_t t_us;          /* since capture start */
+    const uint8_t *bytes;   /* points into the reader's buffer */
+    uint8_t len;
+} ogoa_capture_record_t;
+
+/* Writing: both return the number of bytes put in out, 0 on bad arguments. */
+size_t ogoa_capture_header(uint32_t start_unix_s, uint8_t *out);
+size_t ogoa_capture_record(ogoa_capture_writer_t *w, uint8_t dir, uint32_t now_us,
+                           const uint8_t *data, size_t len, uint8_t *out);
+
+/* Reading straight from a mapped or loaded file; nothing is copied. */
+ogoa_err_t ogoa_capture_open(ogoa_capture_reader_t *r, const uint8_t *data, size_t len);
+/* 1 with a record, 0 at the end, OGOA_ERR_BAD_CAPTURE if it is truncated. */
+int ogoa_capture_next(ogoa_capture_reader_t *r, ogoa_capture_record_t *rec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,447 @@
+#ifndef OGOA_LINK_H
+#define OGOA_LINK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ogoa.h"
+#include "ogoa_msg.h"
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#endif
+
+// ogoa::Link: the OGOA link of ogoa.c as a header-only C++ template, for the
+// same wire format. Sizes are template parameters instead of #defines, and
+// the transport, clock and frame handler are types whose calls are inlined,
+// with no function pointers and no void* context. ogoa.c stays the C API
+// (the SYSMCU side uses it); both ends interoperate.
+//
+//   struct UartTx { int write(const uint8_t* data, size_t len); };   // like ogoa_tx_fn
+//   struct Millis { uint32_t nowMs() { return millis(); } };
+//   struct Rx {
+//       void onFrame(const ogoa::FrameView& frame);
+//       void onError(ogoa_err_t err);
+//   };
+//
+//   ogoa::Link<UartTx, Millis> link(uart, clock);
+//   link.receive(bytes, n, rx);
+//   link.tick(rx);
+//   link.send(ogoa::StatusResponse{ 0u, x, y });
+//
+// Behaviour follows ogoa.c: every frame but a bare ACK is ACKed, and passed
+// on unless it repeats one just seen; a frame not ACKed in time is sent once
+// more, then the link polls with STATUS_REQUEST until a STATUS_RESPONSE
+// arrives. Frames go out through a transmit ring that the transport drains
+// with partial writes. The link keeps ogoa.c's counters (stats) and answers a
+// STATS_REQUEST with them itself, without passing it on. Config::window
+// frames may await their ACK at once; with more than one, the peer has to
+// remember as many frames to drop retransmitted repeats (ogoa.c remembers
+// one, so keep 1 against it).
+
+namespace ogoa {
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+template <typename T>
+using Span = std::span<T>;
+#else
+// The part of std::span (C++20) used here.
+template <typename T>
+class Span {
+public:
+    constexpr Span() : ptr(nullptr), len(0) {}
+    constexpr Span(T* _ptr, size_t _len) : ptr(_ptr), len(_len) {}
+
+    constexpr T* data() const { return ptr; }
+    constexpr size_t size() const { return len; }
+    constexpr bool empty() const { return len == 0; }
+    constexpr T& operator[](size_t i) const { return ptr[i]; }
+    constexpr T* begin() const { return ptr; }
+    constexpr T* end() const { return ptr + len; }
+
+private:
+    T* ptr;
+    size_t len;
+};
+#endif
+
+// A received frame; the payload points into the link's receive buffer and
+// is valid only during onFrame.
+struct FrameView {
+    uint8_t seq;
+    uint8_t type;
+    Span<const uint8_t> payload;
+};
+
+template <typename M>
+inline bool decode(const FrameView& frame, M* out) {
+    return decode(frame.payload.data(), frame.payload.size(), out);
+}
+
+// Same sizes and timings as ogoa.h.
+struct DefaultConfig {
+    static constexpr size_t maxPayload = OGOA_MAX_PAYLOAD;
+    static constexpr size_t txRingBytes = OGOA_TX_RING_BYTES;
+    static constexpr uint8_t window = 1u;
+    static constexpr uint32_t ackTimeoutMs = OGOA_ACK_TIMEOUT_MS;
+    static constexpr uint32_t statusLoopIntervalMs = OGOA_STATUS_LOOP_INTERVAL_MS;
+};
+
+template <typename Transport, typename Clock, typename Config = DefaultConfig>
+class Link {
+public:
+    static constexpr size_t frameBytes = OGOA_HEADER_BYTES + Config::maxPayload + OGOA_CHECKSUM_BYTES;
+    static constexpr size_t ringBytes = Config::txRingBytes;
+
+    static_assert(Config::maxPayload <= OGOA_MAX_PAYLOAD, "the length byte limits payloads to OGOA_MAX_PAYLOAD");
+    static_assert((ringBytes & (ringBytes - 1u)) == 0u && ringBytes >= frameBytes && ringBytes <= 32768u,
+                  "txRingBytes must be a power of two from one frame to 32768");
+    static_assert(Config::window >= 1u, "window must hold at least one frame");
+
+    Link(Transport& _transport, Clock& _clock)
+        : stats(), transport(_transport), clock(_clock), nextSeq(0), pendingCount(0), statusLoop(false),
+          lastActionMs(0), ringHead(0), ringTail(0), ringPeak(0), rxIndex(0), rxExpected(0), rxState(RX_WAIT_START),
+          seenCount(0), seenNext(0) {}
+
+    // OGOA_ERR_TX_FAILED while the window is full or the link polls for
+    // status, OGOA_ERR_TX_BUSY when the ring has no room for the frame.
+    ogoa_err_t send(uint8_t type, Span<const uint8_t> payload) {
+        if (payload.size() > Config::maxPayload) {
+            return OGOA_ERR_PAYLOAD_TOO_LARGE;
+        }
+        bool needsAck = type != OGOA_TYPE_ACK;
+        if (statusLoop || (needsAck && pendingCount == Config::window)) {
+            return OGOA_ERR_TX_FAILED;
+        }
+
+        uint8_t frame[frameBytes];
+        size_t len = build(nextSeq, type, payload.data(), payload.size(), frame);
+        if (!enqueue(frame, len)) {
+            return OGOA_ERR_TX_BUSY;
+        }
+
+        uint32_t now = clock.nowMs();
+        lastActionMs = now;
+        if (needsAck) {
+            Pending& p = pending[pendingCount++];
+            p.seq = nextSeq;
+            p.retried = false;
+            p.sentMs = now;
+            p.len = (uint16_t)len;
+            memcpy(p.frame, frame, len);
+        }
+        nextSeq = (uint8_t)(nextSeq + 1u);
+        return OGOA_OK;
+    }
+
+    template <typename M>
+    ogoa_err_t send(const M& msg) {
+        uint8_t payload[OGOA_MAX_PAYLOAD];
+        return send(M::type, Span<const uint8_t>(payload, encode(msg, payload)));
+    }
+
+    template <typename Handler>
+    void receive(const uint8_t* data, size_t len, Handler& handler) {
+        uint32_t now = clock.nowMs();
+        for (size_t i = 0; i < len; i++) {
+            receiveByte(data[i], now, handler);
+        }
+    }
+
+    // Retries, the status loop, and draining the ring.
+    template <typename Handler>
+    void tick(Handler& handler) {
+        uint32_t now = clock.nowMs();
+        if (flush() < 0) {
+            handler.onError(OGOA_ERR_TX_FAILED);
+        }
+
+        for (uint8_t i = 0; i < pendingCount; i++) {
+            Pending& p = pending[i];
+            if (now - p.sentMs < Config::ackTimeoutMs) {
+                continue;
+            }
+            if (p.retried) {
+                // Second timeout: stop waiting and poll for status instead.
+                pendingCount = 0;
+                statusLoop = true;
+                lastActionMs = now;
+                stats.status_loops++;
+                break;
+            }
+            if (enqueue(p.frame, p.len)) {
+                stats.retransmits++;
+                p.retried = true;
+                p.sentMs = now;
+                lastActionMs = now;
+            } else {
+                handler.onError(OGOA_ERR_TX_BUSY);
+            }
+        }
+
+        if (statusLoop && now - lastActionMs >= Config::statusLoopIntervalMs) {
+            uint8_t frame[OGOA_HEADER_BYTES + OGOA_CHECKSUM_BYTES];
+            size_t len = build(nextSeq, OGOA_TYPE_STATUS_REQUEST, nullptr, 0u, frame);
+            if (enqueue(frame, len)) {
+                nextSeq = (uint8_t)(nextSeq + 1u);
+                lastActionMs = now;
+            } else {
+                handler.onError(OGOA_ERR_TX_BUSY);
+            }
+        }
+    }
+
+    // Hands the transport what it takes now; bytes written, or -1 on a fault.
+    int flush() {
+        int total = 0;
+        while (ringUsed() > 0u) {
+            size_t offset = ringTail & (ringBytes - 1u);
+            size_t chunk = ringBytes - offset;
+            if (chunk > ringUsed()) {
+                chunk = ringUsed();
+            }
+            int written = transport.write(&ring[offset], chunk);
+            if (written < 0) {
+                stats.tx_faults++;
+                return -1;
+            }
+            if ((size_t)written > chunk) {
+                written = (int)chunk;
+            }
+            ringTail = (uint16_t)(ringTail + written);
+            stats.tx_bytes += (uint32_t)written;
+            total += written;
+            if ((size_t)written < chunk) {
+                break;
+            }
+        }
+        return total;
+    }
+
+    size_t txPending() const { return ringUsed(); }
+    size_t txPeak() const { return ringPeak; }
+    uint8_t awaitingAck() const { return pendingCount; }
+    bool pollingStatus() const { return statusLoop; }
+
+    ogoa_stats_t stats;     // as ogoa_ctx_t's, and in the same order on the wire
+
+private:
+    enum RxState : uint8_t {
+        RX_WAIT_START,
+        RX_WAIT_SEQ,
+        RX_WAIT_TYPE,
+        RX_WAIT_LEN,
+        RX_WAIT_PAYLOAD,
+        RX_WAIT_CHECKSUM
+    };
+
+    struct Pending {
+        uint8_t seq;
+        bool retried;
+        uint16_t len;
+        uint32_t sentMs;
+        uint8_t frame[frameBytes];
+    };
+
+    struct Seen {
+        uint8_t seq;
+        uint8_t type;
+        uint8_t len;
+        uint8_t fingerprint;
+    };
+
+    Transport& transport;
+    Clock& clock;
+
+    uint8_t nextSeq;
+    Pending pending[Config::window];
+    uint8_t pendingCount;
+    bool statusLoop;
+    uint32_t lastActionMs;
+
+    uint8_t ring[ringBytes];
+    uint16_t ringHead;
+    uint16_t ringTail;
+    uint16_t ringPeak;
+
+    uint8_t rxBuf[frameBytes];
+    uint16_t rxIndex;
+    uint8_t rxExpected;
+    RxState rxState;
+
+    Seen seen[Config::window];
+    uint8_t seenCount;
+    uint8_t seenNext;
+
+    static uint8_t xorBytes(const uint8_t* p, size_t len) {
+        uint8_t x = 0u;
+        for (size_t i = 0; i < len; i++) {
+            x ^= p[i];
+        }
+        return x;
+    }
+
+    static size_t build(uint8_t seq, uint8_t type, const uint8_t* payload, size_t len, uint8_t* out) {
+        out[0] = OGOA_START_BYTE;
+        out[1] = seq;
+        out[2] = type;
+        out[3] = (uint8_t)len;
+        if (len > 0u) {
+            memcpy(&out[OGOA_HEADER_BYTES], payload, len);
+        }
+        out[OGOA_HEADER_BYTES + len] = xorBytes(out, OGOA_HEADER_BYTES + len);
+        return OGOA_HEADER_BYTES + len + OGOA_CHECKSUM_BYTES;
+    }
+
+    size_t ringUsed() const { return (uint16_t)(ringHead - ringTail); }
+
+    // Whole frame or nothing, then as much as the transport takes.
+    bool enqueue(const uint8_t* data, size_t len) {
+        if (len > ringBytes - ringUsed()) {
+            flush();
+            if (len > ringBytes - ringUsed()) {
+                stats.tx_busy++;
+                return false;
+            }
+        }
+        size_t offset = ringHead & (ringBytes - 1u);
+        size_t first = ringBytes - offset;
+        if (first > len) {
+            first = len;
+        }
+        memcpy(&ring[offset], data, first);
+        memcpy(ring, data + first, len - first);
+        ringHead = (uint16_t)(ringHead + len);
+        stats.tx_frames++;
+        if (ringUsed() > ringPeak) {
+            ringPeak = (uint16_t)ringUsed();
+        }
+        flush();
+        return true;
+    }
+
+    bool sendAck(uint8_t seq) {
+        uint8_t frame[OGOA_HEADER_BYTES + OGOA_CHECKSUM_BYTES];
+        return enqueue(frame, build(seq, OGOA_TYPE_ACK, nullptr, 0u, frame));
+    }
+
+    void ackReceived(uint8_t seq) {
+        for (uint8_t i = 0; i < pendingCount; i++) {
+            if (pending[i].seq == seq) {
+                pending[i] = pending[--pendingCount];
+                return;
+            }
+        }
+    }
+
+    // True if the frame repeats one of the last Config::window frames.
+    bool remember(uint8_t seq, uint8_t type, uint8_t len, const uint8_t* payload) {
+        Seen s = { seq, type, len, (uint8_t)(seq ^ type ^ len ^ xorBytes(payload, len)) };
+        for (uint8_t i = 0; i < seenCount; i++) {
+            const Seen& o = seen[i];
+            if (o.seq == s.seq && o.type == s.type && o.len == s.len && o.fingerprint == s.fingerprint) {
+                return true;
+            }
+        }
+        seen[seenNext] = s;
+        seenNext = (uint8_t)((seenNext + 1u) % Config::window);
+        if (seenCount < Config::window) {
+            seenCount++;
+        }
+        return false;
+    }
+
+    template <typename Handler>
+    void receiveByte(uint8_t byte, uint32_t now, Handler& handler) {
+        stats.rx_bytes++;
+        switch (rxState) {
+            case RX_WAIT_START:
+                if (byte == OGOA_START_BYTE) {
+                    rxBuf[0] = byte;
+                    rxIndex = 1u;
+                    rxState = RX_WAIT_SEQ;
+                }
+                return;
+
+            case RX_WAIT_SEQ:
+                rxBuf[rxIndex++] = byte;
+                rxState = RX_WAIT_TYPE;
+                return;
+
+            case RX_WAIT_TYPE:
+                rxBuf[rxIndex++] = byte;
+                rxState = RX_WAIT_LEN;
+                return;
+
+            case RX_WAIT_LEN:
+                rxBuf[rxIndex++] = byte;
+                rxExpected = byte;
+                if (byte > Config::maxPayload) {
+                    rxState = RX_WAIT_START;
+                    stats.oversize_lengths++;
+                    handler.onError(OGOA_ERR_PAYLOAD_TOO_LARGE);
+                } else {
+                    rxState = (byte == 0u) ? RX_WAIT_CHECKSUM : RX_WAIT_PAYLOAD;
+                }
+                return;
+
+            case RX_WAIT_PAYLOAD:
+                rxBuf[rxIndex++] = byte;
+                if (rxIndex == OGOA_HEADER_BYTES + rxExpected) {
+                    rxState = RX_WAIT_CHECKSUM;
+                }
+                return;
+
+            case RX_WAIT_CHECKSUM:
+                rxState = RX_WAIT_START;
+                if (xorBytes(rxBuf, rxIndex) != byte) {
+                    stats.checksum_errors++;
+                    handler.onError(OGOA_ERR_CHECKSUM);
+                    return;
+                }
+                stats.rx_frames++;
+                frameReceived(now, handler);
+                return;
+        }
+    }
+
+    StatsResponse statsMessage() const {
+        return StatsResponse{ stats.rx_bytes,        stats.tx_bytes,         stats.rx_frames, stats.tx_frames,
+                              stats.checksum_errors, stats.oversize_lengths, stats.retransmits,
+                              stats.status_loops,    stats.duplicates,       stats.tx_busy,   stats.tx_faults };
+    }
+
+    template <typename Handler>
+    void frameReceived(uint32_t now, Handler& handler) {
+        FrameView frame = { rxBuf[1], rxBuf[2], Span<const uint8_t>(&rxBuf[OGOA_HEADER_BYTES], rxExpected) };
+        if (frame.type == OGOA_TYPE_ACK && rxExpected == 0u) {
+            ackReceived(frame.seq);
+            return;
+        }
+        if (!sendAck(frame.seq)) {
+            handler.onError(OGOA_ERR_TX_BUSY);
+            return;
+        }
+        if (remember(frame.seq, frame.type, rxExpected, frame.payload.data())) {
+            stats.duplicates++;
+        } else if (frame.type == OGOA_TYPE_STATS_REQUEST) {
+            // Refused while the window is full; the peer's request times out.
+            send(statsMessage());
+        } else {
+            handler.onFrame(frame);
+        }
+        if (statusLoop && frame.type == OGOA_TYPE_STATUS_RESPONSE) {
+            statusLoop = false;
+        }
+        // As in ogoa.c, traffic from the peer restarts the ACK timeout.
+        lastActionMs = now;
+        for (uint8_t i = 0; i < pendingCount; i++) {
+            pending[i].sentMs = now;
+        }
+    }
+};
+
+}  // namespace ogoa
+
+#endif
@@ -0,0 +1,302 @@
+#ifndef OGOA_MSG_H
+#define OGOA_MSG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <type_traits>
+
+#include "ogoa.h"
+
+// Typed OGOA payloads, for C++ callers of ogoa.h.
+//
+// Each message is a struct that names its type code and lists its wire
+// layout once, in order; offsets and minimum length follow from the field
+// types at compile time, and decode() and encode() are generated from that
+// list. Integers are little endian. A trailing array is not copied: it
+// stays a view into the frame's payload.
+//
+//   struct Example {
+//       static constexpr uint8_t type = 0x42u;
+//       uint8_t id;
+//       uint16_t value;                          // offset 1
+//       ogoa::LeArray<uint16_t> samples;         // offset 3, at least 1
+//       using Layout = ogoa::Layout<Example, OGOA_FIELD(Example, id), OGOA_FIELD(Example, value),
+//                                   OGOA_TAIL(Example, samples, 1)>;
+//   };
+//
+// Dispatcher builds a 256-entry table from type code to typed handler.
+
+namespace ogoa {
+
+template <typename T>
+inline T readLe(const uint8_t* p) {
+    static_assert(std::is_unsigned<T>::value, "wire fields are unsigned integers");
+    T v = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        v = (T)(v | ((T)p[i] << (8u * i)));
+    }
+    return v;
+}
+
+template <typename T>
+inline void writeLe(uint8_t* p, T v) {
+    static_assert(std::is_unsigned<T>::value, "wire fields are unsigned integers");
+    for (size_t i = 0; i < sizeof(T); i++) {
+        p[i] = (uint8_t)(v >> (8u * i));
+    }
+}
+
+// count little-endian T at data, inside a frame's payload.
+template <typename T>
+struct LeArray {
+    typedef T value_type;
+    const uint8_t* data;
+    uint8_t count;
+
+    T operator[](size_t i) const { return readLe<T>(data + i * sizeof(T)); }
+};
+
+template <typename M, typename T, T M::*Member>
+struct Field {
+    static constexpr size_t minBytes = sizeof(T);
+    static constexpr bool isTail = false;
+
+    static void decode(const uint8_t* p, size_t, M& m) { m.*Member = readLe<T>(p); }
+    static size_t encode(const M& m, uint8_t* p) {
+        writeLe<T>(p, m.*Member);
+        return sizeof(T);
+    }
+};
+
+// Everything after the fixed fields, as whole elements.
+template <typename M, typename T, LeArray<T> M::*Member, uint8_t MinCount>
+struct Tail {
+    static constexpr size_t minBytes = (size_t)MinCount * sizeof(T);
+    static constexpr bool isTail = true;
+
+    static void decode(const uint8_t* p, size_t avail, M& m) {
+        (m.*Member).data = p;
+        (m.*Member).count = (uint8_t)(avail / sizeof(T));
+    }
+    static size_t encode(const M& m, uint8_t* p) {
+        size_t n = (size_t)(m.*Member).count * sizeof(T);
+        memcpy(p, (m.*Member).data, n);
+        return n;
+    }
+};
+
+#define OGOA_FIELD(M, name) ::ogoa::Field<M, decltype(M::name), &M::name>
+#define OGOA_TAIL(M, name, minCount) \
+    ::ogoa::Tail<M, typename decltype(M::name)::value_type, &M::name, (minCount)>
+
+template <typename... F>
+constexpr bool tailIsLast() {
+    const bool tails[] = { false, F::isTail... };
+    const size_t n = sizeof(tails) / sizeof(tails[0]);
+    for (size_t i = 1; i + 1 < n; i++) {
+        if (tails[i]) return false;
+    }
+    return true;
+}
+
+template <typename M, typename... F>
+struct Layout {
+    static constexpr size_t minBytes = (F::minBytes + ... + 0u);
+    static_assert(minBytes <= OGOA_MAX_PAYLOAD, "message does not fit in a frame");
+    static_assert(tailIsLast<F...>(), "only the last field may be a tail");
+
+    // len must be at least minBytes.
+    static void decode(const uint8_t* p, size_t len, M& m) {
+        size_t off = 0;
+        ((F::decode(p + off, len - off, m), off += F::minBytes), ...);
+        (void)p, (void)len, (void)m, (void)off;
+    }
+    static size_t encode(const M& m, uint8_t* p) {
+        size_t off = 0;
+        ((off += F::encode(m, p + off)), ...);
+        (void)m, (void)p;
+        return off;
+    }
+};
+
+template <typename M>
+inline bool decode(const uint8_t* payload, size_t len, M* out) {
+    if (len < M::Layout::minBytes) {
+        return false;
+    }
+    M::Layout::decode(payload, len, *out);
+    return true;
+}
+
+template <typename M>
+inline bool decode(const ogoa_frame_t& frame, M* out) {
+    return decode(frame.payload, frame.len, out);
+}
+
+// Returns the payload length; payload needs room for OGOA_MAX_PAYLOAD.
+template <typename M>
+inline uint8_t encode(const M& msg, uint8_t* payload) {
+    return (uint8_t)M::Layout::encode(msg, payload);
+}
+
+// An empty message passes no payload, so nothing reads the unset buffer.
+template <typename M>
+inline ogoa_err_t send(ogoa_ctx_t* ctx, const M& msg, uint32_t nowMs) {
+    uint8_t payload[OGOA_MAX_PAYLOAD];
+    uint8_t len = encode(msg, payload);
+    return ogoa_send(ctx, M::type, len > 0u ? payload : nullptr, len, nowMs);
+}
+
+template <typename M>
+inline ogoa_err_t sendRequest(ogoa_ctx_t* ctx, ogoa_request_t* req, const M& msg, uint32_t nowMs) {
+    uint8_t payload[OGOA_MAX_PAYLOAD];
+    uint8_t len = encode(msg, payload);
+    return ogoa_send_request(ctx, req, M::type, len > 0u ? payload : nullptr, len, nowMs);
+}
+
+// ===== DISPATCH =====
+
+typedef void (*FrameHandler)(const ogoa_frame_t& frame);
+
+// Handler for one message type; Fn only sees frames that decode.
+template <typename M, void (*Fn)(const M& msg, const ogoa_frame_t& frame)>
+struct On {
+    static constexpr uint8_t type = M::type;
+
+    template <FrameHandler Malformed>
+    static void handle(const ogoa_frame_t& frame) {
+        M msg;
+        if (decode(frame, &msg)) {
+            Fn(msg, frame);
+        } else {
+            Malformed(frame);
+        }
+    }
+};
+
+struct HandlerTable {
+    FrameHandler fn[256];
+};
+
+template <FrameHandler Unknown, FrameHandler Malformed, typename... H>
+constexpr HandlerTable buildHandlerTable() {
+    HandlerTable t = {};
+    for (FrameHandler& fn : t.fn) fn = Unknown;
+    ((t.fn[H::type] = &H::template handle<Malformed>), ...);
+    return t;
+}
+
+template <typename... H>
+constexpr bool distinctTypes() {
+    const uint16_t types[] = { 256u, H::type... };
+    const size_t n = sizeof(types) / sizeof(types[0]);
+    for (size_t i = 1; i < n; i++) {
+        for (size_t j = 1; j < i; j++) {
+            if (types[i] == types[j]) return false;
+        }
+    }
+    return true;
+}
+
+// Type code -> handler, as a table built at compile time. Types with no
+// handler go to Unknown, frames too short for their type to Malformed.
+template <FrameHandler Unknown, FrameHandler Malformed, typename... H>
+class Dispatcher {
+public:
+    static_assert(distinctTypes<H...>(), "two handlers for one frame type");
+
+    static void dispatch(const ogoa_frame_t& frame) { table.fn[frame.type](frame); }
+
+private:
+    static constexpr HandlerTable table = buildHandlerTable<Unknown, Malformed, H...>();
+};
+
+// ===== MESSAGES =====
+// Payloads from protocol(1).md.
+
+#define OGOA_SCAN_FLAG_LAST 0x01u
+
+struct Ack {
+    static constexpr uint8_t type = OGOA_TYPE_ACK;
+    using Layout = ogoa::Layout<Ack>;
+};
+
+struct StatusRequest {
+    static constexpr uint8_t type = OGOA_TYPE_STATUS_REQUEST;
+    using Layout = ogoa::Layout<StatusRequest>;
+};
+
+struct StatusResponse {
+    static constexpr uint8_t type = OGOA_TYPE_STATUS_RESPONSE;
+    uint8_t mode;
+    uint8_t x;
+    uint8_t y;
+    using Layout = ogoa::Layout<StatusResponse, OGOA_FIELD(StatusResponse, mode), OGOA_FIELD(StatusResponse, x),
+                                OGOA_FIELD(StatusResponse, y)>;
+};
+
+struct LidarSend {
+    static constexpr uint8_t type = OGOA_TYPE_LIDAR_SEND;
+    uint8_t startTheta;
+    uint8_t deltaTheta;
+    LeArray<uint16_t> distances;
+    using Layout = ogoa::Layout<LidarSend, OGOA_FIELD(LidarSend, startTheta), OGOA_FIELD(LidarSend, deltaTheta),
+                                OGOA_TAIL(LidarSend, distances, 1)>;
+};
+
+struct LidarScan {
+    static constexpr uint8_t type = OGOA_TYPE_LIDAR_SCAN;
+    uint8_t sensor;
+    uint8_t scanSeq;
+    uint16_t startTheta;
+    uint8_t deltaTheta;
+    uint8_t flags;
+    LeArray<uint16_t> distances;
+    using Layout = ogoa::Layout<LidarScan, OGOA_FIELD(LidarScan, sensor), OGOA_FIELD(LidarScan, scanSeq),
+                                OGOA_FIELD(LidarScan, startTheta), OGOA_FIELD(LidarScan, deltaTheta),
+                                OGOA_FIELD(LidarScan, flags), OGOA_TAIL(LidarScan, distances, 1)>;
+};
+
+struct Warning {
+    static constexpr uint8_t type = OGOA_TYPE_WARNING;
+    uint8_t level;
+    uint8_t sensor;
+    uint16_t angleDeg;
+    uint16_t distanceMm;
+    using Layout = ogoa::Layout<Warning, OGOA_FIELD(Warning, level), OGOA_FIELD(Warning, sensor),
+                                OGOA_FIELD(Warning, angleDeg), OGOA_FIELD(Warning, distanceMm)>;
+};
+
+struct StatsRequest {
+    static constexpr uint8_t type = OGOA_TYPE_STATS_REQUEST;
+    using Layout = ogoa::Layout<StatsRequest>;
+};
+
+// ogoa_stats_t on the wire; ogoa.c and ogoa::Link answer a StatsRequest with it.
+struct StatsResponse {
+    static constexpr uint8_t type = OGOA_TYPE_STATS_RESPONSE;
+    uint32_t rxBytes;
+    uint32_t txBytes;
+    uint32_t rxFrames;
+    uint32_t txFrames;
+    uint32_t checksumErrors;
+    uint32_t oversizeLengths;
+    uint32_t retransmits;
+    uint32_t statusLoops;
+    uint32_t duplicates;
+    uint32_t txBusy;
+    uint32_t txFaults;
+    using Layout = ogoa::Layout<StatsResponse, OGOA_FIELD(StatsResponse, rxBytes), OGOA_FIELD(StatsResponse, txBytes),
+                                OGOA_FIELD(StatsResponse, rxFrames), OGOA_FIELD(StatsResponse, txFrames),
+                                OGOA_FIELD(StatsResponse, checksumErrors), OGOA_FIELD(StatsResponse, oversizeLengths),
+                                OGOA_FIELD(StatsResponse, retransmits), OGOA_FIELD(StatsResponse, statusLoops),
+                                OGOA_FIELD(StatsResponse, duplicates), OGOA_FIELD(StatsResponse, txBusy),
+                                OGOA_FIELD(StatsResponse, txFaults)>;
+    static_assert(Layout::minBytes == OGOA_STATS_PAYLOAD_BYTES, "fields of ogoa_stats_t");
+};
+
+}  // namespace ogoa
+
+#endif
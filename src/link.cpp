@@ -0,0 +1,552 @@
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include "link.h"
+#include "CollisionGuard.h"
+#include "ogoa.h"
+#include "ogoa_capture.h"
+#include "ogoa_msg.h"
+#include "Profiler.h"
+#include "Proximity.h"
+#include "TtcTracker.h"
+#include "ScanAssembler.h"
+#include "TraceLog.h"
+
+// Status snapshots go out whenever the link did something, and at least this
+// often so timers (retries, status loop) show up on screen.
+#define LINK_STATUS_PERIOD_MS 20u
+
+// With LINK_CAPTURE=1 every byte received and sent on the link is mirrored,
+// as OGOA capture records, to a second UART. Record it on a host with
+// ogoa_cap record and replay it with ogoa_cap replay (tools/ogoa_cap).
+// Records wait in a ring that is drained only as fast as the UART takes
+// them, so the link never waits for the capture; records that find the ring
+// full are dropped and counted (LinkStatus::captureDropped).
+#ifndef LINK_CAPTURE
+#define LINK_CAPTURE 0
+#endif
+#ifndef LINK_CAPTURE_PORT
+#define LINK_CAPTURE_PORT Serial2
+#endif
+#define LINK_CAPTURE_BAUD 921600
+#define LINK_CAPTURE_RING_BYTES 4096u   // power of two
+
+// Debug log: the event trace as text lines on a UART of its own, so nothing
+// but OGOA frames is ever written to Serial. Drained a little on every loop,
+// only as fast as the port takes it; the link never waits for it.
+#ifndef LINK_DEBUG_LOG
+#define LINK_DEBUG_LOG 1
+#endif
+#ifndef LINK_DEBUG_PORT
+#define LINK_DEBUG_PORT Serial1
+#endif
+#define LINK_DEBUG_BAUD 115200
+
+// With LINK_WARNING_REPORT=1 every collision level change is also sent back
+// as a WARNING (0x57) frame (ogoa::Warning).
+#ifndef LINK_WARNING_REPORT
+#define LINK_WARNING_REPORT 0
+#endif
+#define LINK_HEADING_STALE_MS 750u   // forget the heading after this long without status
+
+#if COLLISION_SENSORS != LINK_SENSORS
+#error "CollisionGuard and the link must agree on the sensor count"
+#endif
+
+LatestMailbox<LinkScan> linkScanBox[LINK_SENSORS];
+LatestMailbox<LinkStatus> linkStatusBox;
+LatestMailbox<LinkWarning> linkWarningBox;
+TraceRing linkTrace;
+TraceLog linkLog(&linkTrace, linkTraceFormat);
+
+// Everything below is owned by core1.
+static ogoa_ctx_t ogoa_link;
+static ScanAssembler scanAssemblers[LINK_SENSORS];
+static uint32_t scanSeq[LINK_SENSORS] = {};
+static ProxEngine proxEngines[LINK_SENSORS];
+static TtcTracker ttcTrackers[LINK_SENSORS];
+static TtcReport ttcReports[LINK_SENSORS];
+static CollisionGuard collisionGuard;
+static uint8_t warningLevel = COLLISION_CLEAR;
+static uint32_t warningSeq = 0;
+static uint32_t warningsRaised = 0;
+static uint32_t warningEvalUsMax = 0;
+static uint32_t frameRxUs = 0;   // when the frame being handled validated
+#if LINK_WARNING_REPORT
+static bool warningReportPending = false;
+static ogoa_request_t warningReport;
+static uint32_t warningsReported = 0;    // ACKed by the SYSMCU
+static uint32_t warningReportsLost = 0;  // no ACK after the retry
+#endif
+
+// Bin 0 is straight out from a sensor and bins run clockwise, so the rear
+// sensor sees the vehicle's left on its right.
+static const ProxSector proxSectors[LINK_SENSORS][LINK_PROX_SECTORS] = {
+    { { 225u, 90u, LINK_PROX_THRESHOLD_MM }, { 315u, 90u, LINK_PROX_THRESHOLD_MM }, { 45u, 90u, LINK_PROX_THRESHOLD_MM } },
+    { { 45u, 90u, LINK_PROX_THRESHOLD_MM }, { 315u, 90u, LINK_PROX_THRESHOLD_MM }, { 225u, 90u, LINK_PROX_THRESHOLD_MM } },
+};
+
+static uint32_t rxAckCount = 0;
+static uint32_t rxStatusReqCount = 0;
+static uint32_t rxStatusRespCount = 0;
+static uint32_t rxLidarCount = 0;
+static uint32_t rxUnknownCount = 0;
+static uint32_t rxMalformedCount = 0;
+static uint8_t remoteMode = 0;
+static uint8_t remoteX = 0;
+static uint8_t remoteY = 0;
+static uint32_t lastStatusRespMs = 0;
+
+static CoreLoad linkLoad;
+static uint32_t lastStatusPublishMs = 0;
+
+#if LINK_CAPTURE
+static ogoa_capture_writer_t captureWriter;
+static uint8_t captureRx[OGOA_CAPTURE_CHUNK_MAX];
+static size_t captureRxLen = 0;
+
+static uint8_t captureRing[LINK_CAPTURE_RING_BYTES];
+static uint16_t captureHead = 0;
+static uint16_t captureTail = 0;
+static uint32_t captureDropped = 0;
+
+static size_t captureUsed() {
+    return (uint16_t)(captureHead - captureTail);
+}
+
+// Whatever the UART's FIFO has room for now.
+static void captureDrain() {
+    while (captureUsed() > 0u) {
+        int room = LINK_CAPTURE_PORT.availableForWrite();
+        if (room <= 0) {
+            return;
+        }
+        size_t offset = captureTail & (LINK_CAPTURE_RING_BYTES - 1u);
+        size_t n = LINK_CAPTURE_RING_BYTES - offset;
+        if (n > captureUsed()) n = captureUsed();
+        if (n > (size_t)room) n = (size_t)room;
+        n = LINK_CAPTURE_PORT.write(&captureRing[offset], n);
+        if (n == 0u) {
+            return;
+        }
+        captureTail = (uint16_t)(captureTail + n);
+    }
+}
+
+static void captureQueue(const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        captureRing[(uint16_t)(captureHead + i) & (LINK_CAPTURE_RING_BYTES - 1u)] = data[i];
+    }
+    captureHead = (uint16_t)(captureHead + len);
+    captureDrain();
+}
+
+// A record without room is never built, so the next one's delta still
+// covers the time it spanned.
+static void captureWrite(uint8_t dir, const uint8_t *data, size_t len) {
+    if (LINK_CAPTURE_RING_BYTES - captureUsed() < 1u + 5u + len) {
+        captureDropped++;
+        return;
+    }
+    uint8_t record[OGOA_CAPTURE_RECORD_MAX];
+    captureQueue(record, ogoa_capture_record(&captureWriter, dir, micros(), data, len, record));
+}
+
+// Received bytes are batched; anything sent flushes them first so the
+// capture keeps the order they happened in.
+static void captureFlushRx() {
+    if (captureRxLen > 0u) {
+        captureWrite(OGOA_CAPTURE_RX, captureRx, captureRxLen);
+        captureRxLen = 0;
+    }
+}
+
+static void captureRxByte(uint8_t b) {
+    captureRx[captureRxLen++] = b;
+    if (captureRxLen == sizeof(captureRx)) {
+        captureFlushRx();
+    }
+}
+
+static void captureTx(const uint8_t *data, size_t len) {
+    captureFlushRx();
+    while (len > 0u) {
+        size_t chunk = (len > OGOA_CAPTURE_CHUNK_MAX) ? OGOA_CAPTURE_CHUNK_MAX : len;
+        captureWrite(OGOA_CAPTURE_TX, data, chunk);
+        data += chunk;
+        len -= chunk;
+    }
+}
+#endif
+
+static int ogoaSerialTx(void *user_ctx, const uint8_t *data, size_t len) {
+    Stream *serial = static_cast<Stream *>(user_ctx);
+    if (serial == nullptr || data == nullptr) {
+        return 0;
+    }
+    // Only what fits in the FIFO now; the OGOA ring keeps the rest.
+    int room = serial->availableForWrite();
+    if (room <= 0) {
+        return 0;
+    }
+    if ((size_t)room < len) {
+        len = (size_t)room;
+    }
+    int sent = (int)serial->write(data, len);
+#if LINK_CAPTURE
+    if (sent > 0) {
+        captureTx(data, (size_t)sent);
+    }
+#endif
+    return sent;
+}
+
+static void sendLocalStatusFrame() {
+    const ogoa::StatusResponse status = { 0u, remoteX, remoteY };
+    (void)ogoa::send(&ogoa_link, status, millis());
+}
+
+#if LINK_WARNING_REPORT
+// A lost report is sent again with whatever level is current by then.
+static void onWarningReportDone(void *, ogoa_request_t *req) {
+    if (req->state == OGOA_REQ_ACKED) {
+        warningsReported++;
+    } else {
+        warningReportsLost++;
+        warningReportPending = true;
+    }
+}
+
+// Tried again from linkLoop while the link is busy with another frame.
+static void sendWarningFrame() {
+    CollisionHit hit = collisionGuard.lastHit;
+    if (warningLevel == COLLISION_CLEAR) {
+        memset(&hit, 0, sizeof(hit));
+    }
+    const ogoa::Warning warning = { warningLevel, hit.sensor, hit.angleDeg, hit.distanceMm };
+    warningReport.done = onWarningReportDone;
+    if (ogoa::sendRequest(&ogoa_link, &warningReport, warning, millis()) == OGOA_OK) {
+        warningReportPending = false;
+    }
+}
+#endif
+
+// Hands a level change to core0 straight away, outside the status cadence.
+static void updateWarning(uint8_t level) {
+    if (level == warningLevel) {
+        return;
+    }
+    if (level > warningLevel) {
+        warningsRaised++;
+    }
+    warningLevel = level;
+
+    LinkWarning &w = linkWarningBox.writeSlot();
+    w.level = level;
+    w.hit = collisionGuard.lastHit;
+    if (level == COLLISION_CLEAR) {
+        w.hit.level = COLLISION_CLEAR;
+    }
+    w.moving = collisionGuard.moving();
+    w.travelDeg = collisionGuard.travelDeg();
+    w.seq = ++warningSeq;
+    w.frameUs = frameRxUs;
+    w.publishedUs = micros();
+    linkWarningBox.publish();
+#if LINK_WARNING_REPORT
+    warningReportPending = true;
+    sendWarningFrame();
+#endif
+}
+
+// Runs on every chunk before it is assembled.
+static void checkCollision(uint8_t sensor, const ScanChunk &chunk) {
+    uint32_t t0 = micros();
+    uint8_t level = collisionGuard.addChunk(sensor, chunk, millis());
+    updateWarning(level);
+    uint32_t us = micros() - t0;
+    if (us > warningEvalUsMax) {
+        warningEvalUsMax = us;
+    }
+}
+
+// Assembler sink: a finished sweep goes straight to its sensor's mailbox.
+static void publishScan(void *ctx, const uint16_t *distances, uint16_t coverage, bool complete) {
+    uint8_t sensor = (uint8_t)(uintptr_t)ctx;
+    LinkScan &scan = linkScanBox[sensor].writeSlot();
+    memcpy(scan.distances, distances, sizeof(scan.distances));
+    scan.sensor = sensor;
+    scan.complete = complete;
+    scan.coverage = coverage;
+    {
+        PROFILE_SCOPE(PROF_PROX);
+        proxEngines[sensor].reduce(scan.distances, &scan.prox);
+    }
+    // Partial scans would skew the closing speed; they keep the last estimate.
+    if (complete) {
+        PROFILE_SCOPE(PROF_TTC);
+        ttcTrackers[sensor].update(scan.prox, millis(), collisionGuard.moving(), collisionGuard.travelDeg(),
+                                   &ttcReports[sensor]);
+    }
+    scan.ttc = ttcReports[sensor];
+    scan.seq = ++scanSeq[sensor];
+    scan.updatedMs = millis();
+    scan.publishedUs = micros();
+    linkScanBox[sensor].publish();
+}
+
+
+size_t linkTraceFormat(const TraceRecord &rec, char *out, size_t len) {
+    int n;
+    switch (rec.id) {
+        case LINK_TRACE_INIT:
+            n = snprintf(out, len, "OGOA init");
+            break;
+        case LINK_TRACE_RX_ACK:
+            n = snprintf(out, len, "RX ACK seq=%u", rec.arg0);
+            break;
+        case LINK_TRACE_RX_STATUS_REQ:
+            n = snprintf(out, len, "RX STATUS_REQ -> TX STATUS_RESP");
+            break;
+        case LINK_TRACE_RX_STATUS_RESP:
+            n = snprintf(out, len, "RX STATUS_RESP m=%u x=%u y=%lu", rec.arg0, rec.arg1, (unsigned long)rec.arg2);
+            break;
+        case LINK_TRACE_RX_LIDAR:
+            n = snprintf(out, len, "RX LIDAR pts=%u", rec.arg1);
+            break;
+        case LINK_TRACE_RX_SCAN:
+            n = snprintf(out, len, "RX SCAN s=%u pts=%u", rec.arg0, rec.arg1);
+            break;
+        case LINK_TRACE_RX_UNKNOWN:
+            n = snprintf(out, len, "RX UNKNOWN type=0x%02X", rec.arg0);
+            break;
+        case LINK_TRACE_RX_MALFORMED:
+            n = snprintf(out, len, "RX SHORT type=0x%02X len=%u", rec.arg0, rec.arg1);
+            break;
+        case LINK_TRACE_ERROR:
+            n = snprintf(out, len, "OGOA ERR %ld", (long)(int32_t)rec.arg2);
+            break;
+        default:
+            n = snprintf(out, len, "event %u (%u %u %lu)", rec.id, rec.arg0, rec.arg1, (unsigned long)rec.arg2);
+            break;
+    }
+    if (n < 0) {
+        return 0u;
+    }
+    return ((size_t)n < len) ? (size_t)n : (len > 0u ? len - 1u : 0u);
+}
+
+// ===== FRAME HANDLERS =====
+// One per message type (ogoa_msg.h), reached through LinkDispatch's table
+// with the payload already decoded and its length checked.
+
+static void onAck(const ogoa::Ack &, const ogoa_frame_t &frame) {
+    rxAckCount++;
+    linkTrace.record(frameRxUs, LINK_TRACE_RX_ACK, frame.seq);
+}
+
+static void onStatusRequest(const ogoa::StatusRequest &, const ogoa_frame_t &) {
+    rxStatusReqCount++;
+    sendLocalStatusFrame();
+    linkTrace.record(frameRxUs, LINK_TRACE_RX_STATUS_REQ);
+}
+
+static void onStatusResponse(const ogoa::StatusResponse &msg, const ogoa_frame_t &) {
+    rxStatusRespCount++;
+    remoteMode = msg.mode;
+    remoteX = msg.x;
+    remoteY = msg.y;
+    lastStatusRespMs = millis();
+    collisionGuard.setHeading(remoteX, remoteY);
+    updateWarning(collisionGuard.level());
+    linkTrace.record(frameRxUs, LINK_TRACE_RX_STATUS_RESP, remoteMode, remoteX, remoteY);
+}
+
+// LIDAR_SEND carries no sensor id or sweep boundaries: it is the front
+// sensor, and a sweep ends when every bin has been seen.
+static void onLidarSend(const ogoa::LidarSend &msg, const ogoa_frame_t &) {
+    rxLidarCount++;
+    ScanChunk chunk = {};
+    chunk.startTheta = msg.startTheta;
+    chunk.deltaTheta = msg.deltaTheta;
+    chunk.count = msg.distances.count;
+    chunk.distances = msg.distances.data;
+    checkCollision(LINK_SENSOR_FRONT, chunk);
+    scanAssemblers[LINK_SENSOR_FRONT].add(chunk, millis());
+    linkTrace.record(frameRxUs, LINK_TRACE_RX_LIDAR, 0u, chunk.count);
+}
+
+static void onLidarScan(const ogoa::LidarScan &msg, const ogoa_frame_t &) {
+    rxLidarCount++;
+    if (msg.sensor >= LINK_SENSORS) {
+        linkTrace.record(frameRxUs, LINK_TRACE_RX_SCAN, msg.sensor, 0u);
+        return;
+    }
+
+    ScanChunk chunk = {};
+    chunk.sequenced = true;
+    chunk.scanSeq = msg.scanSeq;
+    chunk.startTheta = msg.startTheta;
+    chunk.deltaTheta = msg.deltaTheta;
+    chunk.last = (msg.flags & OGOA_SCAN_FLAG_LAST) != 0u;
+    chunk.count = msg.distances.count;
+    chunk.distances = msg.distances.data;
+    checkCollision(msg.sensor, chunk);
+    scanAssemblers[msg.sensor].add(chunk, millis());
+    linkTrace.record(frameRxUs, LINK_TRACE_RX_SCAN, msg.sensor, chunk.count);
+}
+
+static void onUnknownFrame(const ogoa_frame_t &frame) {
+    rxUnknownCount++;
+    linkTrace.record(frameRxUs, LINK_TRACE_RX_UNKNOWN, frame.type);
+}
+
+// Valid checksum, but too short for its type.
+static void onMalformedFrame(const ogoa_frame_t &frame) {
+    rxMalformedCount++;
+    linkTrace.record(frameRxUs, LINK_TRACE_RX_MALFORMED, frame.type, frame.len);
+}
+
+typedef ogoa::Dispatcher<onUnknownFrame, onMalformedFrame,
+                         ogoa::On<ogoa::Ack, onAck>,
+                         ogoa::On<ogoa::StatusRequest, onStatusRequest>,
+                         ogoa::On<ogoa::StatusResponse, onStatusResponse>,
+                         ogoa::On<ogoa::LidarSend, onLidarSend>,
+                         ogoa::On<ogoa::LidarScan, onLidarScan>> LinkDispatch;
+
+static void ogoaOnFrame(void *user_ctx, const ogoa_frame_t *frame) {
+    (void)user_ctx;
+    if (frame == nullptr) {
+        return;
+    }
+    frameRxUs = micros();
+    LinkDispatch::dispatch(*frame);
+}
+
+static void ogoaOnError(void *user_ctx, ogoa_err_t err) {
+    (void)user_ctx;
+    linkTrace.record(micros(), LINK_TRACE_ERROR, 0u, 0u, (uint32_t)(int32_t)err);
+}
+
+static const ogoa_ops_t ogoa_link_ops = {
+    .tx = ogoaSerialTx,
+    .on_frame = ogoaOnFrame,
+    .on_error = ogoaOnError
+};
+
+static void publishStatus(uint32_t now) {
+    LinkStatus &st = linkStatusBox.writeSlot();
+    st.rxAckCount = rxAckCount;
+    st.rxStatusReqCount = rxStatusReqCount;
+    st.rxStatusRespCount = rxStatusRespCount;
+    st.rxLidarCount = rxLidarCount;
+    st.rxUnknownCount = rxUnknownCount;
+    st.rxMalformedCount = rxMalformedCount;
+    for (uint8_t s = 0; s < LINK_SENSORS; ++s) {
+        st.scansComplete[s] = scanAssemblers[s].completeScans;
+        st.scansPartial[s] = scanAssemblers[s].partialScans;
+    }
+    st.warningsRaised = warningsRaised;
+    st.warningEvalUsMax = warningEvalUsMax;
+#if LINK_WARNING_REPORT
+    st.warningsReported = warningsReported;
+    st.warningReportsLost = warningReportsLost;
+#endif
+#if LINK_CAPTURE
+    st.captureDropped = captureDropped;
+#endif
+    st.remoteMode = remoteMode;
+    st.remoteX = remoteX;
+    st.remoteY = remoteY;
+    st.lastStatusRespMs = lastStatusRespMs;
+    st.rxIndex = ogoa_link.rx_index;
+    st.rxState = ogoa_link.rx_state;
+    memcpy(st.rxBuf, ogoa_link.rx_buf, sizeof(st.rxBuf));
+    st.txState = (uint8_t)ogoa_tx_state(&ogoa_link);
+    st.txPendingSeq = ogoa_link.tx_pending_seq;
+    st.txLastActionMs = ogoa_link.tx_last_action_ms;
+    st.txQueued = (uint16_t)ogoa_tx_pending(&ogoa_link);
+    st.txQueuedPeak = ogoa_link.tx_ring_peak;
+    ogoa_stats_snapshot(&ogoa_link, &st.ogoa);
+    st.cpuPercent = linkLoad.percent;
+    st.publishedUs = micros();
+    linkStatusBox.publish();
+    lastStatusPublishMs = now;
+}
+
+void linkSetup() {
+    Serial.begin(115200);
+#if LINK_CAPTURE
+    uint8_t header[OGOA_CAPTURE_HEADER_BYTES];
+    LINK_CAPTURE_PORT.begin(LINK_CAPTURE_BAUD);
+    captureQueue(header, ogoa_capture_header(0u, header));
+#endif
+    ogoa_init(&ogoa_link, &ogoa_link_ops, static_cast<Stream *>(&Serial));
+    for (uint8_t s = 0; s < LINK_SENSORS; ++s) {
+        scanAssemblers[s].setSink(publishScan, (void *)(uintptr_t)s);
+        proxEngines[s].setSectors(proxSectors[s], LINK_PROX_SECTORS);
+
+        uint16_t centres[LINK_PROX_SECTORS];
+        for (uint8_t k = 0; k < LINK_PROX_SECTORS; ++k) {
+            const ProxSector &sec = proxSectors[s][k];
+            centres[k] = (uint16_t)((sec.startDeg + sec.spanDeg / 2u + (s == LINK_SENSOR_REAR ? 180u : 0u)) % 360u);
+        }
+        ttcTrackers[s].setSectorAngles(centres, LINK_PROX_SECTORS);
+    }
+    linkLoad.windowStartUs = micros();
+    linkTrace.record(micros(), LINK_TRACE_INIT);
+#if LINK_DEBUG_LOG
+    LINK_DEBUG_PORT.begin(LINK_DEBUG_BAUD);
+    linkLog.begin(&LINK_DEBUG_PORT);
+#endif
+    publishStatus(millis());
+}
+
+void linkLoop() {
+    uint32_t t0 = micros();
+    uint32_t now = millis();
+    bool worked = false;
+
+    {
+        PROFILE_SCOPE(PROF_LINK_TICK);
+        ogoa_tick(&ogoa_link, now);
+    }
+    if (Serial.available() > 0) {
+        PROFILE_SCOPE(PROF_LINK_DRAIN);
+        while (Serial.available() > 0) {
+            uint8_t b = (uint8_t)Serial.read();
+#if LINK_CAPTURE
+            captureRxByte(b);
+#endif
+            ogoa_process_byte(&ogoa_link, b, millis());
+        }
+#if LINK_CAPTURE
+        captureFlushRx();
+#endif
+        worked = true;
+    }
+
+    for (uint8_t s = 0; s < LINK_SENSORS; ++s) {
+        scanAssemblers[s].poll(now);
+    }
+    if (collisionGuard.moving() && (now - lastStatusRespMs) > LINK_HEADING_STALE_MS) {
+        collisionGuard.setHeading(COLLISION_JOY_CENTRE, COLLISION_JOY_CENTRE);
+    }
+    frameRxUs = micros();
+    updateWarning(collisionGuard.poll(now));
+#if LINK_WARNING_REPORT
+    if (warningReportPending) {
+        sendWarningFrame();
+    }
+#endif
+    if (worked || (now - lastStatusPublishMs) >= LINK_STATUS_PERIOD_MS) {
+        publishStatus(now);
+    }
+    linkLog.poll();
+#if LINK_CAPTURE
+    captureDrain();
+#endif
+
+    uint32_t t1 = micros();
+    linkLoad.add(worked ? (t1 - t0) : 0u, t1);
+}
@@ -0,0 +1,145 @@
+#ifndef LINK_H
+#define LINK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CollisionGuard.h"
+#include "Mailbox.h"
+#include "ogoa.h"
+#include "Proximity.h"
+#include "Trace.h"
+#include "TraceLog.h"
+#include "TtcTracker.h"
+
+// The OGOA link runs on core1 (setup1/loop1) and owns the ogoa_ctx_t and the
+// serial port. It hands results to the render core through mailboxes and
+// the event trace; the render core never touches the link state directly.
+
+#define LINK_SCAN_BINS 360
+#define LINK_SENSORS 2          // 0 = front, 1 = rear
+#define LINK_SENSOR_FRONT 0
+#define LINK_SENSOR_REAR 1
+// Proximity sectors reported with every scan, relative to the vehicle: each
+// sensor's sectors are set up so LEFT is the vehicle's left side.
+#define LINK_PROX_SECTORS 3
+#define LINK_PROX_LEFT 0
+#define LINK_PROX_AHEAD 1       // straight out from the sensor
+#define LINK_PROX_RIGHT 2
+#define LINK_PROX_THRESHOLD_MM 500u
+#define LINK_EVENT_CHARS 64
+#define LINK_RX_PEEK_BYTES 10
+
+// One finished sweep from one sensor (see ScanAssembler). Bins the sweep did
+// not cover are 0.
+struct LinkScan {
+    uint16_t distances[LINK_SCAN_BINS];
+    uint8_t sensor;
+    bool complete;          // false if cut short by a timeout or a new sweep
+    uint16_t coverage;      // bins written
+    ProxReport prox;        // LINK_PROX_* sectors of this scan
+    TtcReport ttc;          // time to collision per LINK_PROX_* sector
+    uint32_t seq;           // bumps on every scan published for this sensor
+    uint32_t updatedMs;
+    uint32_t publishedUs;
+};
+
+// Collision zone state, published by core1 as soon as a chunk or a heading
+// change moves the level (see CollisionGuard).
+struct LinkWarning {
+    uint8_t level;          // CollisionLevel
+    CollisionHit hit;       // what raised it (level CLEAR when clearing)
+    bool moving;
+    uint16_t travelDeg;
+    uint32_t seq;
+    uint32_t frameUs;       // micros() when the frame that caused it validated
+    uint32_t publishedUs;
+};
+
+// Snapshot of everything the dashboard shows about the link.
+struct LinkStatus {
+    uint32_t rxAckCount;
+    uint32_t rxStatusReqCount;
+    uint32_t rxStatusRespCount;
+    uint32_t rxLidarCount;
+    uint32_t rxUnknownCount;
+    uint32_t rxMalformedCount;  // too short for their type
+    uint32_t scansComplete[LINK_SENSORS];
+    uint32_t scansPartial[LINK_SENSORS];
+    uint32_t warningsRaised;
+    uint32_t warningEvalUsMax;  // worst chunk check on core1
+    uint32_t warningsReported;  // Warning frames ACKed (LINK_WARNING_REPORT)
+    uint32_t warningReportsLost;
+    uint32_t captureDropped;    // capture records with no ring room (LINK_CAPTURE)
+
+    uint8_t remoteMode;
+    uint8_t remoteX;
+    uint8_t remoteY;
+    uint32_t lastStatusRespMs;
+
+    uint8_t rxIndex;
+    uint8_t rxState;
+    uint8_t rxBuf[LINK_RX_PEEK_BYTES];
+    uint8_t txState;        // ogoa_tx_state_t
+    uint8_t txPendingSeq;
+    uint32_t txLastActionMs;
+    uint16_t txQueued;      // bytes in the OGOA transmit ring
+    uint16_t txQueuedPeak;
+    ogoa_stats_t ogoa;      // the OGOA context's own counters
+
+    uint8_t cpuPercent;     // link core utilisation over the last second
+    uint32_t publishedUs;
+};
+
+// Share of wall time a loop spent doing work, over one-second windows.
+// Written by one core; percent may be read from anywhere.
+struct CoreLoad {
+    uint32_t windowStartUs;
+    uint32_t busyUs;
+    volatile uint8_t percent;
+
+    // Returns true when a window closed and percent was updated.
+    bool add(uint32_t us, uint32_t nowUs) {
+        busyUs += us;
+        uint32_t span = nowUs - windowStartUs;
+        if (span < 1000000u) {
+            return false;
+        }
+        percent = (uint8_t)(((uint64_t)busyUs * 100u) / span);
+        busyUs = 0u;
+        windowStartUs = nowUs;
+        return true;
+    }
+};
+
+// Link events, recorded in linkTrace as they happen (arguments in brackets)
+// and only turned into text by linkTraceFormat() when something shows them.
+enum LinkTraceEvent {
+    LINK_TRACE_INIT = 0,
+    LINK_TRACE_RX_ACK,            // [seq]
+    LINK_TRACE_RX_STATUS_REQ,     // answered with STATUS_RESPONSE
+    LINK_TRACE_RX_STATUS_RESP,    // [mode, x, y]
+    LINK_TRACE_RX_LIDAR,          // [-, points]
+    LINK_TRACE_RX_SCAN,           // [sensor, points]
+    LINK_TRACE_RX_UNKNOWN,        // [type]
+    LINK_TRACE_RX_MALFORMED,      // [type, len]
+    LINK_TRACE_ERROR,             // [-, -, ogoa_err_t]
+    LINK_TRACE_EVENT_COUNT
+};
+
+// Written by core1 only; readable from either core (see TraceRing).
+extern TraceRing linkTrace;
+// Core1's debug log of linkTrace (LINK_DEBUG_LOG), for its counters.
+extern TraceLog linkLog;
+
+// One line of text for a record, e.g. "RX SCAN s=1 pts=60".
+size_t linkTraceFormat(const TraceRecord& rec, char* out, size_t len);
+
+extern LatestMailbox<LinkScan> linkScanBox[LINK_SENSORS];
+extern LatestMailbox<LinkStatus> linkStatusBox;
+extern LatestMailbox<LinkWarning> linkWarningBox;
+
+// Core1 entry points.
+void linkSetup();
+void linkLoop();
+
+#endif
@@ -7,14 +7,20 @@
 #include "LidarPolar.h"
 #include "LidarGraph.h"
 #include "ProxBar.h"
+#include "TextPanel.h"
+#include "WarningBanner.h"
+#include "Compositor.h"
+#include "Scheduler.h"
+#include "Profiler.h"
+#include "Life.h"
+#include "link.h"
 #include "ogoa.h"
 
 
 // ================= CONFIGURATION =================
-#define CONWAY_GRID (100)
 #define SCALE (2)
-#define SPRITE_W (CONWAY_GRID * SCALE)
-#define SPRITE_H (CONWAY_GRID * SCALE)
+#define SPRITE_W (LIFE_COLS * SCALE)
+#define SPRITE_H (LIFE_ROWS * SCALE)
 
 // Screen Dimensions (Landscape)
 #define SCREEN_W 480
@@ -24,6 +30,36 @@
 #define X_OFFSET ((SCREEN_W - SPRITE_W) / 2)
 #define Y_OFFSET ((SCREEN_H - SPRITE_H) / 2)
 
+// Protocol overlay band at the top of the dashboard
+#define OVERLAY_H 50
+// Memory and boot report along the bottom
+#define MEMORY_REPORT_H 10
+
+// Frame scheduling (microseconds unless noted)
+#define RENDER_FPS_MAX 30
+#define FRAME_BUDGET_US 25000u      // time per pass before low-priority work waits
+#define RENDER_BUDGET_US 15000u
+#define RENDER_DEADLINE_US 50000u   // from data change to tiles on the panel, rate cap included
+#define SIM_INTERVAL_US 33000u
+#define OVERLAY_INTERVAL_US 100000u
+#define OVERLAY_BUDGET_US 2000u
+#define OVERLAY_MAX_DEFER_US 500000u
+#define PROFILE_PANEL_Y 256
+#define PROFILE_PANEL_W 176
+#define PROFILE_PANEL_H 48
+#define PROFILE_INTERVAL_US 500000u
+
+// Prox bars: full at 0 mm, empty at PROX_BAR_RANGE_MM and beyond
+#define PROX_BAR_RANGE_MM 2000u
+#define PROX_STALE_MS 750u
+
+// Collision banner between the profile columns. Exactly 4 compositor tiles,
+// so an urgent update pushes as little as possible.
+#define WARNING_X 176
+#define WARNING_Y 256
+#define WARNING_W 128
+#define WARNING_H 32
+
 // Colors
 #define C_BLACK TFT_BLACK
 #define C_WHITE TFT_WHITE
@@ -35,205 +71,696 @@
 
 TFT_eSPI tft = TFT_eSPI();           
 
-// Intro Animation Sprite
-TFT_eSprite* introSprite = nullptr; 
-
-// Dashboard Widgets
-LidarPolar* frontLidar = nullptr;
-LidarPolar* rearLidar  = nullptr;
-ProxBar* proxLeft   = nullptr;
-ProxBar* proxRight  = nullptr;
-ogoa_ctx_t ogoa_link;
-static uint32_t lastLidarUpdateMs = 0;
-static uint32_t rxAckCount = 0;
-static uint32_t rxStatusReqCount = 0;
-static uint32_t rxStatusRespCount = 0;
-static uint32_t rxLidarCount = 0;
-static uint32_t rxUnknownCount = 0;
-static uint8_t remoteMode = 0;
-static uint8_t remoteX = 0;
-static uint8_t remoteY = 0;
-static uint32_t lastStatusRespMs = 0;
-static char lastProtoEvent[64] = "OGOA init";
-static uint32_t lastProtoEventMs = 0;
-
-static int ogoaSerialTx(void *user_ctx, const uint8_t *data, size_t len) {
-    Stream *serial = static_cast<Stream *>(user_ctx);
-    if (serial == nullptr || data == nullptr) {
-        return 0;
+// Intro Animation Sprite (its pixels are the one big allocation, freed at
+// the switch to the dashboard)
+static TFT_eSprite introSprite(&tft);
+static uint32_t lifeStepUsMax = 0;   // slowest generation of the intro
+static uint32_t bootMs = 0;          // power-on to dashboard
+static uint32_t dashboardUs = 0;     // when the dashboard took over the panel
+static uint32_t firstScanMs = 0;     // power-on to the first scan on the panel
+static uint32_t setupHeapFree = 0;   // heap left once setup() is done
+static bool firstScanQueued = false; // a scan is in the widgets, not yet pushed
+
+// ================= LAYOUT =================
+// The whole dashboard, fixed at compile time. Every widget is a static object
+// built from its row here, and the compositor's shadow map is reserved
+// statically too, so nothing the dashboard uses comes from the heap. The
+// only allocation is the compositor's 2 KB tile sprite, once, in setup().
+enum LayoutKind : uint8_t { LAYOUT_TEXT, LAYOUT_POLAR, LAYOUT_PROX, LAYOUT_BANNER };
+
+struct LayoutEntry {
+    uint8_t kind;           // LayoutKind
+    int16_t x, y, w, h;
+    uint16_t fg, bg;
+    uint16_t rangeMm;       // LAYOUT_POLAR only
+};
+
+enum LayoutSlot {
+    SLOT_OVERLAY,           // protocol overlay across the top
+    SLOT_FRONT_LIDAR,       // two big graphs in the middle
+    SLOT_REAR_LIDAR,
+    SLOT_PROX_LEFT,         // prox bars on the sides
+    SLOT_PROX_RIGHT,
+    SLOT_BANNER,            // collision banner under the graphs
+    SLOT_MEMORY,            // memory and boot report along the bottom
+#if PROFILER_ENABLED
+    SLOT_PROFILE_LEFT,      // stage timings either side of the banner
+    SLOT_PROFILE_RIGHT,
+#endif
+    SLOT_COUNT
+};
+
+static constexpr LayoutEntry dashboardLayout[SLOT_COUNT] = {
+    { LAYOUT_TEXT,   0,   0,   SCREEN_W, OVERLAY_H, C_WHITE, C_BLACK, 0u },
+    { LAYOUT_POLAR,  40,  50,  200,      200,       C_GREEN, C_BLACK, 4000u },
+    { LAYOUT_POLAR,  260, 50,  200,      200,       C_CYAN,  C_BLACK, 4000u },
+    { LAYOUT_PROX,   10,  50,  20,       150,       0u,      0u,      0u },
+    { LAYOUT_PROX,   460, 50,  20,       150,       0u,      0u,      0u },
+    { LAYOUT_BANNER, WARNING_X, WARNING_Y, WARNING_W, WARNING_H, 0u, 0u, 0u },
+    { LAYOUT_TEXT,   0, SCREEN_H - MEMORY_REPORT_H, SCREEN_W, MEMORY_REPORT_H, C_WHITE, C_BLACK, 0u },
+#if PROFILER_ENABLED
+    { LAYOUT_TEXT,   0, PROFILE_PANEL_Y, PROFILE_PANEL_W, PROFILE_PANEL_H, C_CYAN, C_BLACK, 0u },
+    { LAYOUT_TEXT,   SCREEN_W - PROFILE_PANEL_W, PROFILE_PANEL_Y, PROFILE_PANEL_W, PROFILE_PANEL_H, C_CYAN, C_BLACK, 0u },
+#endif
+};
+
+static constexpr bool layoutOnScreen() {
+    for (const LayoutEntry& e : dashboardLayout) {
+        if (e.x < 0 || e.y < 0 || e.w <= 0 || e.h <= 0 || e.x + e.w > SCREEN_W || e.y + e.h > SCREEN_H) {
+            return false;
+        }
     }
-    return (int)serial->write(data, len);
+    return true;
 }
 
-static void sendLocalStatusFrame() {
-    uint8_t payload[3];
-    payload[0] = 0u;
-    payload[1] = remoteX;
-    payload[2] = remoteY;
-    (void)ogoa_send(&ogoa_link, OGOA_TYPE_STATUS_RESPONSE, payload, (uint8_t)sizeof(payload), millis());
+static_assert(SLOT_COUNT <= COMPOSITOR_MAX_WIDGETS, "dashboard has more widgets than the compositor takes");
+static_assert(layoutOnScreen(), "dashboard widget off the screen");
+
+static TextPanel makeText(const LayoutEntry& e) {
+    return TextPanel(nullptr, e.x, e.y, e.w, e.h, e.fg, e.bg);
 }
 
-static void drawProtocolOverlay() {
-    char l1[64];
-    char l2[96];
-    char l3[128];
-    char l4[128];
-    size_t pos = 0u;
-    uint32_t ageMs = millis() - lastProtoEventMs;
-    uint32_t txAgeMs = millis() - ogoa_link.tx_last_action_ms;
+static LidarPolar makePolar(const LayoutEntry& e) {
+    return LidarPolar(nullptr, e.x, e.y, e.w, e.h, e.fg, e.rangeMm);
+}
 
-    snprintf(l1, sizeof(l1), "%s (%lums)", lastProtoEvent, (unsigned long)ageMs);
-    snprintf(
-        l2,
-        sizeof(l2),
-        "ack:%lu req:%lu resp:%lu lidar:%lu unk:%lu",
-        (unsigned long)rxAckCount,
-        (unsigned long)rxStatusReqCount,
-        (unsigned long)rxStatusRespCount,
-        (unsigned long)rxLidarCount,
-        (unsigned long)rxUnknownCount
-    );
+static ProxBar makeProx(const LayoutEntry& e) {
+    return ProxBar(nullptr, e.x, e.y, e.w, e.h);
+}
+
+static WarningBanner makeBanner(const LayoutEntry& e) {
+    return WarningBanner(nullptr, e.x, e.y, e.w, e.h);
+}
+
+// Dashboard Widgets (drawn through the compositor's shared tile buffer)
+Compositor compositor(&tft, SCREEN_W, SCREEN_H, C_BLACK);
+static uint8_t compositorShadow[COMPOSITOR_SHADOW_BYTES(SCREEN_W, SCREEN_H)];
+
+static TextPanel overlayWidget = makeText(dashboardLayout[SLOT_OVERLAY]);
+static LidarPolar frontLidarWidget = makePolar(dashboardLayout[SLOT_FRONT_LIDAR]);
+static LidarPolar rearLidarWidget = makePolar(dashboardLayout[SLOT_REAR_LIDAR]);
+static ProxBar proxLeftWidget = makeProx(dashboardLayout[SLOT_PROX_LEFT]);
+static ProxBar proxRightWidget = makeProx(dashboardLayout[SLOT_PROX_RIGHT]);
+static WarningBanner bannerWidget = makeBanner(dashboardLayout[SLOT_BANNER]);
+static TextPanel memoryWidget = makeText(dashboardLayout[SLOT_MEMORY]);
+
+TextPanel* const protoOverlay = &overlayWidget;
+LidarPolar* const frontLidar = &frontLidarWidget;
+LidarPolar* const rearLidar  = &rearLidarWidget;
+ProxBar* const proxLeft   = &proxLeftWidget;
+ProxBar* const proxRight  = &proxRightWidget;
+WarningBanner* const warningBanner = &bannerWidget;
+TextPanel* const memoryReport = &memoryWidget;
+#if PROFILER_ENABLED
+static TextPanel profileLeftWidget = makeText(dashboardLayout[SLOT_PROFILE_LEFT]);
+static TextPanel profileRightWidget = makeText(dashboardLayout[SLOT_PROFILE_RIGHT]);
+TextPanel* const profilePanels[2] = { &profileLeftWidget, &profileRightWidget };   // stage timings, profiling builds only
+#endif
+
+// In slot order, which is also the compositor's drawing order.
+static Widget* const dashboardWidgets[SLOT_COUNT] = {
+    &overlayWidget,
+    &frontLidarWidget,
+    &rearLidarWidget,
+    &proxLeftWidget,
+    &proxRightWidget,
+    &bannerWidget,
+    &memoryWidget,
+#if PROFILER_ENABLED
+    &profileLeftWidget,
+    &profileRightWidget,
+#endif
+};
 
-    pos += (size_t)snprintf(l3 + pos, sizeof(l3) - pos, "rx idx:%u st:%u ", ogoa_link.rx_index, ogoa_link.rx_state);
-    for (uint8_t i = 0; i < 10u && pos < sizeof(l3); ++i) {
-        pos += (size_t)snprintf(l3 + pos, sizeof(l3) - pos, "%02X ", ogoa_link.rx_buf[i]);
+// Static RAM the dashboard reserves, checked against a budget at build time
+// (the linker's region totals come from -Wl,--print-memory-usage).
+#define DASHBOARD_RAM_BUDGET (40u * 1024u)
+
+static constexpr size_t dashboardStaticBytes() {
+    size_t bytes = sizeof(compositorShadow);
+    for (const LayoutEntry& e : dashboardLayout) {
+        bytes += (e.kind == LAYOUT_TEXT)    ? sizeof(TextPanel)
+               : (e.kind == LAYOUT_POLAR)   ? sizeof(LidarPolar)
+               : (e.kind == LAYOUT_PROX)    ? sizeof(ProxBar)
+                                            : sizeof(WarningBanner);
+    }
+    return bytes;
+}
+
+static_assert(dashboardStaticBytes() <= DASHBOARD_RAM_BUDGET, "dashboard static RAM over budget");
+
+// Render core's copy of the link state (see link.h)
+static LinkStatus linkStatus;
+static CoreLoad renderLoad;
+static uint32_t scanLatencyMaxUs = 0;      // worst hand-over this window
+static uint32_t scanLatencyShownUs = 0;    // worst hand-over last window
+static ProxReport proxReports[LINK_SENSORS];
+static uint32_t proxUpdatedMs[LINK_SENSORS];
+static bool proxSeen[LINK_SENSORS];
+static uint32_t warningLatencyUs = 0;      // frame validated -> banner on the panel, last raise
+static uint32_t warningLatencyMaxUs = 0;
+static LinkWarning zoneWarning;            // latest collision zone state
+static TtcReport ttcReports[LINK_SENSORS];
+
+static uint32_t schedulerClockUs() {
+    return micros();
+}
+
+Scheduler scheduler(schedulerClockUs, FRAME_BUDGET_US);
+
+// Ages are shown at 100 ms resolution, so a line only changes (and is only
+// formatted) when something it shows has changed.
+#define OVERLAY_AGE_STEP_MS 100u
+
+static uint32_t overlayUsMax = 0;   // slowest overlay update so far
+
+struct OverlayEventKey {
+    uint32_t seq;
+    uint32_t ageSteps;
+};
+
+struct OverlayCountKey {
+    uint32_t ack, req, resp, lidar, unk;
+    uint32_t overlayUsMax;
+    uint8_t cpuRender, cpuLink;
+    uint32_t latencyUs;
+};
+
+struct OverlayRxKey {
+    uint32_t checksumErrors, oversize, duplicates;
+    uint8_t index;
+    uint8_t state;
+    uint8_t buf[10];
+};
+
+struct OverlayTxKey {
+    uint32_t ageSteps;
+    uint32_t misses;
+    uint32_t deferrals;
+    uint32_t retransmits;
+    uint8_t state, pending;
+    uint8_t mode, x, y;
+};
+
+static const char *overlayTxStateName(uint8_t state) {
+    switch (state) {
+        case OGOA_TX_IDLE:
+            return "idle";
+        case OGOA_TX_WAIT_ACK:
+            return "wait-ack";
+        case OGOA_TX_WAIT_ACK_RETRIED:
+            return "retried";
+        case OGOA_TX_WAIT_RESPONSE:
+            return "wait-rsp";
+        case OGOA_TX_STATUS_LOOP:
+            return "status-loop";
+        default:
+            return "?";
+    }
+}
+
+// Compares a line's inputs with what is on screen and remembers them.
+// Keys are compared bytewise, so callers zero them before filling them in.
+static bool overlayKeyChanged(void *shown, const void *now, size_t len, bool force) {
+    if (!force && memcmp(shown, now, len) == 0) {
+        return false;
+    }
+    memcpy(shown, now, len);
+    return true;
+}
+
+static void updateProtocolOverlay() {
+    static OverlayEventKey shownEvent;
+    static OverlayCountKey shownCounts;
+    static OverlayRxKey shownRx;
+    static OverlayTxKey shownTx;
+    static bool primed = false;
+
+    uint32_t t0 = micros();
+    uint32_t now = millis();
+    bool force = !primed;
+    primed = true;
+
+    // Newest link event, straight from the trace ring; only formatted when
+    // it or its age on screen changes.
+    OverlayEventKey ev;
+    TraceRecord rec;
+    memset(&ev, 0, sizeof(ev));
+    ev.seq = linkTrace.count();
+    bool haveEvent = linkTrace.read(ev.seq - 1u, &rec);
+    if (haveEvent) {
+        ev.ageSteps = (micros() - rec.us) / (OVERLAY_AGE_STEP_MS * 1000u);
+    }
+    if (overlayKeyChanged(&shownEvent, &ev, sizeof(ev), force)) {
+        char event[LINK_EVENT_CHARS];
+        char l1[96];
+        if (!haveEvent) {
+            snprintf(event, sizeof(event), "-");
+        } else {
+            linkTraceFormat(rec, event, sizeof(event));
+        }
+        snprintf(l1, sizeof(l1), "%s (%lums)", event, (unsigned long)(ev.ageSteps * OVERLAY_AGE_STEP_MS));
+        protoOverlay->setText(0, l1);
+    }
+
+    OverlayCountKey counts;
+    memset(&counts, 0, sizeof(counts));
+    counts.ack = linkStatus.rxAckCount;
+    counts.req = linkStatus.rxStatusReqCount;
+    counts.resp = linkStatus.rxStatusRespCount;
+    counts.lidar = linkStatus.rxLidarCount;
+    counts.unk = linkStatus.rxUnknownCount;
+    counts.overlayUsMax = overlayUsMax;
+    counts.cpuRender = renderLoad.percent;
+    counts.cpuLink = linkStatus.cpuPercent;
+    counts.latencyUs = scanLatencyShownUs;
+    if (overlayKeyChanged(&shownCounts, &counts, sizeof(counts), force)) {
+        char l2[96];
+        snprintf(
+            l2,
+            sizeof(l2),
+            "ack:%lu req:%lu resp:%lu lidar:%lu unk:%lu ovl:%luus c0:%u%% c1:%u%% q:%luus",
+            (unsigned long)counts.ack,
+            (unsigned long)counts.req,
+            (unsigned long)counts.resp,
+            (unsigned long)counts.lidar,
+            (unsigned long)counts.unk,
+            (unsigned long)counts.overlayUsMax,
+            counts.cpuRender,
+            counts.cpuLink,
+            (unsigned long)counts.latencyUs
+        );
+        protoOverlay->setText(1, l2);
+    }
+
+    OverlayRxKey rx;
+    memset(&rx, 0, sizeof(rx));
+    rx.index = linkStatus.rxIndex;
+    rx.state = linkStatus.rxState;
+    memcpy(rx.buf, linkStatus.rxBuf, sizeof(rx.buf));
+    rx.checksumErrors = linkStatus.ogoa.checksum_errors;
+    rx.oversize = linkStatus.ogoa.oversize_lengths;
+    rx.duplicates = linkStatus.ogoa.duplicates;
+    if (overlayKeyChanged(&shownRx, &rx, sizeof(rx), force)) {
+        char l3[96];
+        size_t pos = 0u;
+        pos += (size_t)snprintf(l3 + pos, sizeof(l3) - pos, "rx idx:%u st:%u ", rx.index, rx.state);
+        for (uint8_t i = 0; i < sizeof(rx.buf) && pos < sizeof(l3); ++i) {
+            pos += (size_t)snprintf(l3 + pos, sizeof(l3) - pos, "%02X ", rx.buf[i]);
+        }
+        if (pos < sizeof(l3)) {
+            snprintf(l3 + pos, sizeof(l3) - pos, "crc:%lu big:%lu dup:%lu", (unsigned long)rx.checksumErrors,
+                     (unsigned long)rx.oversize, (unsigned long)rx.duplicates);
+        }
+        protoOverlay->setText(2, l3);
+    }
+
+    OverlayTxKey tx;
+    memset(&tx, 0, sizeof(tx));
+    tx.ageSteps = (now - linkStatus.txLastActionMs) / OVERLAY_AGE_STEP_MS;
+    tx.state = linkStatus.txState;
+    tx.pending = linkStatus.txPendingSeq;
+    tx.retransmits = linkStatus.ogoa.retransmits;
+    tx.mode = linkStatus.remoteMode;
+    tx.x = linkStatus.remoteX;
+    tx.y = linkStatus.remoteY;
+    tx.misses = scheduler.totalMisses();
+    tx.deferrals = scheduler.totalDeferrals();
+    if (overlayKeyChanged(&shownTx, &tx, sizeof(tx), force)) {
+        char l4[96];
+        snprintf(
+            l4,
+            sizeof(l4),
+            "tx %s pend:%u rt:%lu age:%lums m:%u x:%u y:%u miss:%lu def:%lu",
+            overlayTxStateName(tx.state),
+            tx.pending,
+            (unsigned long)tx.retransmits,
+            (unsigned long)(tx.ageSteps * OVERLAY_AGE_STEP_MS),
+            tx.mode,
+            tx.x,
+            tx.y,
+            (unsigned long)tx.misses,
+            (unsigned long)tx.deferrals
+        );
+        protoOverlay->setText(3, l4);
+    }
+
+    uint32_t us = micros() - t0;
+    if (us > overlayUsMax) {
+        overlayUsMax = us;
+    }
+}
+
+// The line at the bottom of the dashboard: pixel RAM used by the widgets and
+// the compositor tile next to what per-widget RGB565 sprites would take, free
+// heap now and after setup() (the intro sprite's is back by now, and nothing
+// should have been taken since), and how long boot took (to the dashboard,
+// to the first scan on it).
+static void updateMemoryReport() {
+    size_t used = compositor.bufferBytes();
+    size_t rgb565 = 0u;
+    char line[96];
+
+    for (Widget* wgt : dashboardWidgets) {
+        used += wgt->spriteBytes();
+        rgb565 += (size_t)wgt->w * (size_t)wgt->h * 2u;
     }
 
     snprintf(
-        l4,
-        sizeof(l4),
-        "tx wait:%u pend:%u retry:%u loop:%u age:%lums m:%u x:%u y:%u",
-        ogoa_link.tx_waiting_ack,
-        ogoa_link.tx_pending_seq,
-        ogoa_link.tx_retried_once,
-        ogoa_link.tx_status_loop,
-        (unsigned long)txAgeMs,
-        remoteMode,
-        remoteX,
-        remoteY
+        line,
+        sizeof(line),
+        "px %lu/%lu B heap %lu/%lu B boot %lu ms scan %lu ms life %lu us",
+        (unsigned long)used,
+        (unsigned long)rgb565,
+        (unsigned long)rp2040.getFreeHeap(),
+        (unsigned long)setupHeapFree,
+        (unsigned long)bootMs,
+        (unsigned long)firstScanMs,
+        (unsigned long)lifeStepUsMax
     );
+    memoryReport->setText(0, line);
+}
+
+static const char *const sectorNames[LINK_PROX_SECTORS] = { "left", "ahead", "right" };
+
+// The banner shows whichever is worse: the collision zones (SLOW, STOP) or
+// the time to collision, which escalates through three levels as it drops.
+// Zones win a tie, being measured rather than predicted.
+static void refreshBanner() {
+    char title[WARNING_BANNER_CHARS];
+    char detail[WARNING_BANNER_CHARS];
+    uint8_t level = WarningBanner::BANNER_QUIET;
+    uint32_t now = millis();
+
+    if (zoneWarning.level != COLLISION_CLEAR) {
+        bool stop = zoneWarning.level == COLLISION_STOP;
+        level = stop ? WarningBanner::BANNER_DANGER : WarningBanner::BANNER_CAUTION;
+        snprintf(title, sizeof(title), "%s", stop ? "STOP" : "SLOW");
+        snprintf(detail, sizeof(detail), "%umm at %udeg", zoneWarning.hit.distanceMm, zoneWarning.hit.angleDeg);
+    }
 
-    tft.fillRect(0, 0, SCREEN_W, 56, C_BLACK);
-    tft.setTextDatum(TL_DATUM);
-    tft.setTextColor(C_WHITE, C_BLACK);
-    tft.drawString(l1, 4, 2, 2);
-    tft.drawString(l2, 4, 16, 1);
-    tft.drawString(l3, 4, 28, 1);
-    tft.drawString(l4, 4, 40, 1);
+    for (uint8_t sensor = 0; sensor < LINK_SENSORS; ++sensor) {
+        const TtcReport &ttc = ttcReports[sensor];
+        if (!proxSeen[sensor] || (now - proxUpdatedMs[sensor]) > PROX_STALE_MS || ttc.level <= level) {
+            continue;
+        }
+        // TtcLevel and the banner levels escalate in step.
+        level = ttc.level;
+        const TtcSector &sec = ttc.sectors[ttc.worstSector];
+        snprintf(title, sizeof(title), "TTC %u.%us", sec.ttcMs / 1000u, (sec.ttcMs % 1000u) / 100u);
+        snprintf(detail, sizeof(detail), "%s %s %dmm/s", (sensor == LINK_SENSOR_FRONT) ? "front" : "rear",
+                 sectorNames[ttc.worstSector], sec.closingMmS);
+    }
+
+    if (level == WarningBanner::BANNER_QUIET) {
+        snprintf(title, sizeof(title), "clear");
+        snprintf(detail, sizeof(detail), "last %luus max %luus", (unsigned long)warningLatencyUs,
+                 (unsigned long)warningLatencyMaxUs);
+    }
+    warningBanner->setWarning(level, title, detail);
+    compositor.updateWidget(warningBanner);
 }
 
-static void applyLidarPayload(const ogoa_frame_t *frame) {
-    if (frame == nullptr || frame->len < 4u) {
-        return;
+// Pull whatever the link core has published since the last frame.
+// Each sensor's scans arrive whole, so a widget never shows two sweeps mixed.
+static void pollLink() {
+    LidarPolar *radars[LINK_SENSORS] = { frontLidar, rearLidar };
+
+    for (uint8_t sensor = 0; sensor < LINK_SENSORS; ++sensor) {
+        const LinkScan *scan = linkScanBox[sensor].fetch();
+        if (scan == nullptr) {
+            continue;
+        }
+        // Scans held over from the intro say nothing about the hand-over.
+        if ((int32_t)(scan->publishedUs - dashboardUs) >= 0) {
+            uint32_t latencyUs = micros() - scan->publishedUs;
+            if (latencyUs > scanLatencyMaxUs) {
+                scanLatencyMaxUs = latencyUs;
+            }
+        }
+        for (uint16_t angle = 0; angle < LINK_SCAN_BINS; ++angle) {
+            radars[sensor]->updatePoint(angle, scan->distances[angle]);
+        }
+        proxReports[sensor] = scan->prox;
+        ttcReports[sensor] = scan->ttc;
+        proxUpdatedMs[sensor] = scan->updatedMs;
+        proxSeen[sensor] = true;
+        if (firstScanMs == 0u) {
+            firstScanQueued = true;
+        }
     }
 
-    uint8_t startTheta = frame->payload[0];
-    uint8_t deltaTheta = frame->payload[1];
-    if (deltaTheta == 0u) {
-        return;
+    const LinkStatus *status = linkStatusBox.fetch();
+    if (status != nullptr) {
+        linkStatus = *status;
     }
+    refreshBanner();
+}
 
-    uint8_t distanceBytes = (uint8_t)(frame->len - 2u);
-    uint8_t pointCount = (uint8_t)(distanceBytes / 2u);
+// ================= FRAME TASKS =================
+// The link mailboxes are checked on every pass; rendering runs when a widget
+// changed, capped at RENDER_FPS_MAX; the overlay is the first thing dropped
+// when a pass runs long.
+static bool linkReady(void *ctx) {
+    (void)ctx;
+    return linkScanBox[LINK_SENSOR_FRONT].pending() || linkScanBox[LINK_SENSOR_REAR].pending() ||
+           linkStatusBox.pending();
+}
 
-    for (uint8_t i = 0; i < pointCount; ++i) {
-        uint8_t lo = frame->payload[(size_t)2u + (size_t)i * 2u];
-        uint8_t hi = frame->payload[(size_t)3u + (size_t)i * 2u];
-        uint16_t distMm = (uint16_t)((uint16_t)hi << 8u) | (uint16_t)lo;
-        uint16_t angle = (uint16_t)((startTheta + (uint16_t)i * deltaTheta) % 360u);
+static void taskPollLink(void *ctx) {
+    (void)ctx;
+    pollLink();
+}
 
-        if (frontLidar != nullptr) {
-            frontLidar->updatePoint(angle, distMm);
+// Nearest return in one vehicle-relative sector over every sensor with a
+// recent scan. Returns false if no sensor has one.
+static bool proxNearest(uint8_t sector, uint32_t nowMs, uint16_t *minMm) {
+    bool fresh = false;
+    *minMm = PROX_NONE;
+    for (uint8_t sensor = 0; sensor < LINK_SENSORS; ++sensor) {
+        if (!proxSeen[sensor] || (nowMs - proxUpdatedMs[sensor]) > PROX_STALE_MS) {
+            continue;
+        }
+        fresh = true;
+        uint16_t mm = proxReports[sensor].sectors[sector].minMm;
+        if (mm < *minMm) {
+            *minMm = mm;
         }
     }
+    return fresh;
+}
 
-    lastLidarUpdateMs = millis();
+static int proxLevel(uint16_t minMm) {
+    if (minMm >= PROX_BAR_RANGE_MM) {
+        return 0;
+    }
+    return (int)(((PROX_BAR_RANGE_MM - minMm) * 100u) / PROX_BAR_RANGE_MM);
 }
 
-static void ogoaOnFrame(void *user_ctx, const ogoa_frame_t *frame) {
-    (void)user_ctx;
-    if (frame == nullptr) {
+// Prox bars follow the LiDAR sectors; without scans they fall back to the
+// SYSMCU's x/y, and to fake values while it is not sending status either.
+static void taskSimulate(void *ctx) {
+    (void)ctx;
+    uint32_t now = millis();
+    uint16_t leftMm, rightMm;
+    bool haveLeft = proxNearest(LINK_PROX_LEFT, now, &leftMm);
+    bool haveRight = proxNearest(LINK_PROX_RIGHT, now, &rightMm);
+
+    if (haveLeft || haveRight) {
+        proxLeft->setValue(proxLevel(leftMm));
+        proxRight->setValue(proxLevel(rightMm));
         return;
     }
 
-    switch (frame->type) {
-        case OGOA_TYPE_ACK:
-            rxAckCount++;
-            snprintf(lastProtoEvent, sizeof(lastProtoEvent), "RX ACK seq=%u", frame->seq);
-            lastProtoEventMs = millis();
-            break;
+    float t = now / 500.0;
+    int val1 = 50 + 40 * sin(t); 
+    int val2 = 50 + 40 * cos(t * 1.5);
 
-        case OGOA_TYPE_STATUS_REQUEST:
-            rxStatusReqCount++;
-            sendLocalStatusFrame();
-            snprintf(lastProtoEvent, sizeof(lastProtoEvent), "RX STATUS_REQ -> TX STATUS_RESP");
-            lastProtoEventMs = millis();
-            break;
+    if ((now - linkStatus.lastStatusRespMs) > 750u) {
+        proxLeft->setValue(abs(val1));
+        proxRight->setValue(abs(val2));
+    } else {
+        proxLeft->setValue((int)linkStatus.remoteX);
+        proxRight->setValue((int)linkStatus.remoteY);
+    }
+}
 
-        case OGOA_TYPE_STATUS_RESPONSE:
-            rxStatusRespCount++;
-            if (frame->len >= 3u) {
-                remoteMode = frame->payload[0];
-                remoteX = frame->payload[1];
-                remoteY = frame->payload[2];
-                lastStatusRespMs = millis();
-                if (proxLeft != nullptr) {
-                    proxLeft->setValue((int)remoteX);
-                }
-                if (proxRight != nullptr) {
-                    proxRight->setValue((int)remoteY);
-                }
-                snprintf(lastProtoEvent, sizeof(lastProtoEvent), "RX STATUS_RESP m=%u x=%u y=%u", remoteMode, remoteX, remoteY);
-                lastProtoEventMs = millis();
-            }
-            break;
+static bool warningReady(void *ctx) {
+    (void)ctx;
+    return linkWarningBox.pending();
+}
 
-        case OGOA_TYPE_LIDAR_SEND:
-            rxLidarCount++;
-            applyLidarPayload(frame);
-            snprintf(lastProtoEvent, sizeof(lastProtoEvent), "RX LIDAR pts=%u", (unsigned)((frame->len >= 2u) ? ((frame->len - 2u) / 2u) : 0u));
-            lastProtoEventMs = millis();
-            break;
+// Collision level changes skip the render rate cap: a render in progress
+// stops at the next tile (see setYield below), the banner's tiles are pushed
+// on the spot, then the latency from the frame that caused it is measured.
+static void taskWarning(void *ctx) {
+    (void)ctx;
+    const LinkWarning *warn = linkWarningBox.fetch();
+    if (warn == nullptr) {
+        return;
+    }
+    zoneWarning = *warn;
+    refreshBanner();
 
-        default:
-            rxUnknownCount++;
-            snprintf(lastProtoEvent, sizeof(lastProtoEvent), "RX UNKNOWN type=0x%02X", frame->type);
-            lastProtoEventMs = millis();
-            break;
+    if (warn->level != COLLISION_CLEAR && (int32_t)(warn->frameUs - dashboardUs) >= 0) {
+        warningLatencyUs = micros() - warn->frameUs;
+        if (warningLatencyUs > warningLatencyMaxUs) {
+            warningLatencyMaxUs = warningLatencyUs;
+        }
+#if PROFILER_ENABLED
+        profilerRecord(PROF_WARNING, warningLatencyUs * profilerTicksPerUs());
+#endif
     }
 }
 
-static void ogoaOnError(void *user_ctx, ogoa_err_t err) {
-    Stream *serial = static_cast<Stream *>(user_ctx);
-    if (serial != nullptr) {
-        serial->print("OGOA ERR: ");
-        serial->println((int)err);
+static bool renderReady(void *ctx) {
+    (void)ctx;
+    return compositor.pending();
+}
+
+// Once the first scan's tiles are all out, boot is over as far as the
+// driver can tell.
+static void noteFirstScan() {
+    if (!firstScanQueued || compositor.pending()) {
+        return;
     }
-    snprintf(lastProtoEvent, sizeof(lastProtoEvent), "OGOA ERR %d", (int)err);
-    lastProtoEventMs = millis();
+    firstScanQueued = false;
+    firstScanMs = millis();
+    updateMemoryReport();
+}
+
+static void taskRender(void *ctx) {
+    (void)ctx;
+    compositor.update();
+    noteFirstScan();
+}
+
+static void taskOverlay(void *ctx) {
+    (void)ctx;
+    PROFILE_SCOPE(PROF_OVERLAY);
+    updateProtocolOverlay();
+}
+
+#if PROFILER_ENABLED
+// One stage per line, down the left column then the right: name and
+// p50/p99/max in microseconds.
+static void taskProfile(void *ctx) {
+    (void)ctx;
+    for (uint8_t stage = 0; stage < PROF_STAGE_COUNT; ++stage) {
+        uint8_t panel = stage / TEXT_PANEL_MAX_LINES;
+        if (panel >= 2) {
+            break;
+        }
+        ProfileSummary sum;
+        profilerSummary(stage, &sum);
+        char text[TEXT_PANEL_LINE_CHARS];
+        snprintf(
+            text,
+            sizeof(text),
+            "%-5s %4lu/%5lu/%6lu us",
+            profilerStageName(stage),
+            (unsigned long)sum.p50Us,
+            (unsigned long)sum.p99Us,
+            (unsigned long)sum.maxUs
+        );
+        profilePanels[panel]->setText(stage % TEXT_PANEL_MAX_LINES, text);
+    }
+}
+#endif
+
+static void setupFrameTasks() {
+    SchedulerTaskConfig link = {};
+    link.name = "link";
+    link.fn = taskPollLink;
+    link.ready = linkReady;
+    link.priority = SCHED_CRITICAL;
+    scheduler.add(link);
+
+    SchedulerTaskConfig warning = {};
+    warning.name = "warning";
+    warning.fn = taskWarning;
+    warning.ready = warningReady;
+    warning.priority = SCHED_CRITICAL;
+    scheduler.add(warning);
+
+    SchedulerTaskConfig sim = {};
+    sim.name = "sim";
+    sim.fn = taskSimulate;
+    sim.intervalUs = SIM_INTERVAL_US;
+    sim.priority = SCHED_NORMAL;
+    scheduler.add(sim);
+
+    SchedulerTaskConfig render = {};
+    render.name = "render";
+    render.fn = taskRender;
+    render.ready = renderReady;
+    render.intervalUs = 1000000u / RENDER_FPS_MAX;
+    render.budgetUs = RENDER_BUDGET_US;
+    render.deadlineUs = RENDER_DEADLINE_US;
+    render.priority = SCHED_NORMAL;
+    scheduler.add(render);
+
+    SchedulerTaskConfig overlay = {};
+    overlay.name = "overlay";
+    overlay.fn = taskOverlay;
+    overlay.intervalUs = OVERLAY_INTERVAL_US;
+    overlay.budgetUs = OVERLAY_BUDGET_US;
+    overlay.priority = SCHED_LOW;
+    overlay.maxDeferUs = OVERLAY_MAX_DEFER_US;
+    scheduler.add(overlay);
+
+#if PROFILER_ENABLED
+    SchedulerTaskConfig profile = {};
+    profile.name = "profile";
+    profile.fn = taskProfile;
+    profile.intervalUs = PROFILE_INTERVAL_US;
+    profile.priority = SCHED_LOW;
+    scheduler.add(profile);
+#endif
 }
 
-ogoa_ops_t ogoa_link_ops = {
-    .tx = ogoaSerialTx,
-    .on_frame = ogoaOnFrame,
-    .on_error = ogoaOnError
-};
 // State Machine
 typedef enum { RENDER_LOGO, RENDER_APP } main_state_t;
 main_state_t c_state = RENDER_LOGO;
 
 // Conway Globals
-static uint8_t grid[CONWAY_GRID][CONWAY_GRID];
-static uint8_t prev[CONWAY_GRID][CONWAY_GRID];
+static LifeGrid life;
 uint16_t loadingProgress = 0; 
-const int8_t offsets[8][2] = {{-1,-1},{0,-1},{1,-1},{-1,0},{1,0},{-1,1},{0,1},{1,1}};
+
+
+// ================= DASHBOARD =================
+// Attached during setup(), behind the intro. The widgets are static (see
+// LAYOUT), so the switch to the dashboard has nothing left to allocate.
+static bool buildDashboard() {
+    if (!compositor.begin(compositorShadow)) {
+        return false;
+    }
+
+    protoOverlay->addLine(2, 2);
+    protoOverlay->addLine(16, 1);
+    protoOverlay->addLine(28, 1);
+    protoOverlay->addLine(40, 1);
+    warningBanner->setWarning(WarningBanner::BANNER_QUIET, "clear", "");
+    memoryReport->addLine(0, 1);
+#if PROFILER_ENABLED
+    for (uint8_t p = 0; p < 2; ++p) {
+        profilePanels[p]->addLine(2, 1);
+        profilePanels[p]->addLine(13, 1);
+        profilePanels[p]->addLine(24, 1);
+        profilePanels[p]->addLine(35, 1);
+    }
+#endif
+
+    for (Widget *wgt : dashboardWidgets) {
+        compositor.add(wgt);
+    }
+    compositor.setYield(warningReady, nullptr);
+    return true;
+}
 
 
 // ================= SETUP =================
 void setup() {
-    Serial.begin(115200);
-    ogoa_init(&ogoa_link, &ogoa_link_ops, static_cast<Stream *>(&Serial));
-    
     // Hardware Init
     tft.init();
     tft.setRotation(1); 
@@ -242,85 +769,97 @@ void setup() {
     pinMode(TFT_BL, OUTPUT);
     digitalWrite(TFT_BL, HIGH); 
    
-    // Initialize Intro Sprite ONLY (Save RAM)
-    introSprite = new TFT_eSprite(&tft);
-    introSprite->setColorDepth(16);
-    introSprite->createSprite(SPRITE_W, SPRITE_H);
-    introSprite->fillSprite(C_BLACK);
+    // Without the compositor's tile there is no dashboard to switch to;
+    // the link core carries on regardless.
+    if (!buildDashboard()) {
+        tft.setTextColor(C_RED, C_WHITE);
+        tft.setTextDatum(MC_DATUM);
+        tft.drawString("display: no memory for the tile buffer", SCREEN_W/2, SCREEN_H/2, 2);
+        while (true) {
+            delay(1000);
+        }
+    }
+
+    // The intro is optional: without its sprite only the loading bar runs
+    introSprite.setColorDepth(16);
+    introSprite.createSprite(SPRITE_W, SPRITE_H);
+    introSprite.fillSprite(C_BLACK);
 
     // Init Conway Grid
-    for (int i = 0; i < CONWAY_GRID; i++) {
-        for (int j = 0; j < CONWAY_GRID; j++) {
-            grid[i][j] = (rand() % 100) < 15;
-            if(grid[i][j]) introSprite->fillRect(j * SCALE, i * SCALE, SCALE, SCALE, C_GREEN);
+    for (uint16_t i = 0; i < LIFE_ROWS; i++) {
+        for (uint16_t j = 0; j < LIFE_COLS; j++) {
+            bool alive = (rand() % 100) < 15;
+            life.set(i, j, alive);
+            if (alive) introSprite.fillRect(j * SCALE, i * SCALE, SCALE, SCALE, C_GREEN);
         }
     }
-    memcpy(prev, grid, sizeof(grid));
-    introSprite->pushSprite(X_OFFSET, Y_OFFSET);
+    if (introSprite.created()) {
+        introSprite.pushSprite(X_OFFSET, Y_OFFSET);
+    }
+    setupHeapFree = rp2040.getFreeHeap();
+}
+
+
+// ================= LINK CORE =================
+// Core1 owns the OGOA link from boot; see link.cpp.
+void setup1() {
+    linkSetup();
+}
+
+void loop1() {
+    linkLoop();
 }
 
 
 // ================= ANIMATION LOOP =================
+static void drawLifeRun(void* ctx, uint16_t row, uint16_t col, uint16_t len, bool alive) {
+    (void)ctx;
+    introSprite.fillRect(col * SCALE, row * SCALE, len * SCALE, SCALE, alive ? C_GREEN : C_BLACK);
+}
+
 void playStartupAnimation() {
     static unsigned long lastFrameTime = 0;
     if (millis() - lastFrameTime < 33) return; 
     lastFrameTime = millis();
 
-    // 1. Update Game of Life
-    for (int i = 0; i < CONWAY_GRID; i++) {
-      for (int j = 0; j < CONWAY_GRID; j++) {
-        if (prev[i][j] != grid[i][j]) {
-            uint16_t color = grid[i][j] ? C_GREEN : C_BLACK;
-            introSprite->fillRect(j * SCALE, i * SCALE, SCALE, SCALE, color);
-        }
-      }
+    // 1. Sim Logic
+    uint32_t stepStart = micros();
+    life.step();
+    uint32_t stepUs = micros() - stepStart;
+    if (stepUs > lifeStepUsMax) lifeStepUsMax = stepUs;
+
+    // 2. Draw what changed, one rect per run of cells
+    if (introSprite.created()) {
+        life.forEachChangedRun(drawLifeRun, nullptr);
+        introSprite.pushSprite(X_OFFSET, Y_OFFSET);
     }
-    introSprite->pushSprite(X_OFFSET, Y_OFFSET);
 
-    // 2. Loading Bar
+    // 3. Loading Bar
     loadingProgress += 4; 
     tft.fillRect(0, tft.height() - 10, loadingProgress, 10, C_GREEN);
 
-    // 3. Sim Logic
-    memcpy(prev, grid, sizeof(grid));
-    for (int i = 0; i < CONWAY_GRID; i++) {
-      for (int j = 0; j < CONWAY_GRID; j++) {
-        uint8_t living_num = 0;
-        for (int z = 0; z < 8; z++) {
-            int ni = (i + offsets[z][0] + CONWAY_GRID) % CONWAY_GRID;
-            int nj = (j + offsets[z][1] + CONWAY_GRID) % CONWAY_GRID;
-            if (prev[ni][nj]) living_num++;
-        }
-        if (prev[i][j]) grid[i][j] = (living_num == 2 || living_num == 3);
-        else grid[i][j] = (living_num == 3);
-      }
-    }
-
     // 4. TRANSITION TO APP
     if (loadingProgress >= tft.width()) {
         
         // A. DELETE INTRO MEMORY
-        introSprite->deleteSprite();
-        delete introSprite;
-        introSprite = nullptr;
-
-        // B. CLEAR SCREEN
-        tft.fillScreen(C_BLACK);
-        
-        // C. INITIALIZE WIDGETS (Now we allocate the main app memory)
-        // Two big graphs in the middle
-        frontLidar = new LidarPolar(&tft, 40, 50, 200, 200, C_GREEN, 4000);
-        rearLidar  = new LidarPolar(&tft, 260, 50, 200, 200, C_CYAN, 4000);
-        
-        // Prox bars on the sides
-        proxLeft   = new ProxBar(&tft, 10, 50, 20, 150);
-        proxRight  = new ProxBar(&tft, 470, 50, 20, 150); // Edge of screen
-
-        // Draw Static UI Text
-        tft.setTextColor(C_WHITE, C_BLACK);
-        tft.setTextDatum(MC_DATUM);
-        tft.drawString("SYSTEM READY", SCREEN_W/2, 20, 4);
-        lastProtoEventMs = millis();
+        introSprite.deleteSprite();
+
+        // B. FIRST FRAME: the link core kept running through the intro, so
+        // each sensor's latest scan is waiting in its mailbox. Take them, then
+        // paint every tile straight over the intro (no blank screen first).
+        dashboardUs = micros();
+        compositor.invalidateAll();
+        pollLink();
+        do {
+            compositor.update();
+        } while (compositor.pending());
+        bootMs = millis();
+        if (firstScanQueued) {
+            firstScanQueued = false;
+            firstScanMs = bootMs;
+        }
+        updateMemoryReport();
+        setupFrameTasks();
 
         // Switch State
         c_state = RENDER_APP;
@@ -330,47 +869,27 @@ void playStartupAnimation() {
 
 // ================= MAIN LOOP =================
 void loop() {
+    uint32_t t0 = micros();
+    bool worked = false;
+
     switch (c_state) {
         case RENDER_LOGO:
             playStartupAnimation();
             break;
 
         case RENDER_APP:
-            // 1. SIMULATE DATA (Replace this with real sensor reads)
-            static long lastUpdate = 0;
-            if (millis() - lastUpdate > 33) { // 30 FPS Update
-                lastUpdate = millis();
-                ogoa_tick(&ogoa_link, millis());
-
-                // Create some noisy sine waves
-                float t = millis() / 500.0;
-                int val1 = 50 + 40 * sin(t); 
-                int val2 = 50 + 40 * cos(t * 1.5);
-                
-                while (Serial.available() > 0)
-                {
-                    ogoa_process_byte(&ogoa_link, (uint8_t)Serial.read(), millis());
-                }
-                if ((millis() - lastStatusRespMs) > 750u) {
-                    proxLeft->setValue(abs(val1));
-                    proxRight->setValue(abs(val2));
-                }
-
-                // RENDER THE WIDGETS
-                frontLidar->draw();
-                frontLidar->push();
-
-                rearLidar->draw();
-                rearLidar->push();
-
-                proxLeft->draw();
-                proxLeft->push();
-
-                proxRight->draw();
-                proxRight->push();
-
-                drawProtocolOverlay();
-            }
+            worked = scheduler.runPass() > 0;
             break;
     }
+
+    uint32_t t1 = micros();
+#if PROFILER_ENABLED
+    if (worked) {
+        profilerRecord(PROF_FRAME, (t1 - t0) * profilerTicksPerUs());
+    }
+#endif
+    if (renderLoad.add(worked ? (t1 - t0) : 0u, t1)) {
+        scanLatencyShownUs = scanLatencyMaxUs;
+        scanLatencyMaxUs = 0;
+    }
 };
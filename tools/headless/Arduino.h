@@ -0,0 +1,105 @@
+#ifndef HEADLESS_ARDUINO_H
+#define HEADLESS_ARDUINO_H
+
+// Just enough of the Arduino core to build the firmware code on a host.
+// Serial ports only return what a host tool feed()s them and count what is
+// written to them.
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PI 3.1415926535897932384626433832795
+
+#define OUTPUT 1
+#define INPUT 0
+#define HIGH 1
+#define LOW 0
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+
+// Host-only: run millis()/micros() from a simulated clock instead of the
+// steady clock, for replays that must not depend on how fast the host is.
+void headlessSetMicros(uint64_t us);
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+inline void pinMode(int, int) {}
+inline void digitalWrite(int, int) {}
+
+class Stream {
+public:
+    virtual ~Stream() {}
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int availableForWrite() { return 256; }
+    virtual size_t write(uint8_t) { return 1; }
+    virtual size_t write(const uint8_t*, size_t len) { return len; }
+    size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t println(const char* s) { return print(s) + print("\r\n"); }
+    size_t println(int v) {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%d", v);
+        return println(buf);
+    }
+};
+
+// Depth of the modelled TX FIFO (the RP2040/RP2350 UART's).
+#define HEADLESS_UART_FIFO 32
+
+class HardwareSerial : public Stream {
+public:
+    // Once begun, availableForWrite() follows a TX FIFO draining at the baud
+    // rate on the (possibly simulated) clock. write() still takes everything.
+    void begin(unsigned long baud) { txBaud = baud; }
+    void setTX(int) {}
+    void setRX(int) {}
+    operator bool() { return true; }
+
+    int available() override { return (int)(rxLen - rxPos); }
+    int read() override { return (rxPos < rxLen) ? rxData[rxPos++] : -1; }
+    int availableForWrite() override;
+    size_t write(uint8_t) override { return write(nullptr, 1u); }
+    size_t write(const uint8_t*, size_t len) override;
+
+    // Host-only: the next bytes read() returns. Not copied; keep them alive
+    // until they have been read.
+    void feed(const uint8_t* data, size_t len) { rxData = data; rxLen = len; rxPos = 0; }
+    uint64_t txBytes = 0;
+
+private:
+    unsigned long txBaud = 0;
+    uint64_t txIdleAtNs = 0;     // when everything written so far is out
+    const uint8_t* rxData = nullptr;
+    size_t rxLen = 0;
+    size_t rxPos = 0;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+
+// Subset of arduino-pico's rp2040 helper object.
+class RP2040Host {
+public:
+    int getFreeHeap() { return 0; }
+    int getUsedHeap() { return 0; }
+    int getTotalHeap() { return 0; }
+    uint32_t f_cpu() { return 150000000u; }
+    uint32_t getCycleCount();
+};
+
+extern RP2040Host rp2040;
+
+#endif
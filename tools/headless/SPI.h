@@ -0,0 +1,6 @@
+#ifndef HEADLESS_SPI_H
+#define HEADLESS_SPI_H
+
+// The headless TFT_eSPI has no bus; nothing to declare.
+
+#endif
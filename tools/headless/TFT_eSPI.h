@@ -0,0 +1,189 @@
+#ifndef HEADLESS_TFT_ESPI_H
+#define HEADLESS_TFT_ESPI_H
+
+// In-memory stand-in for the parts of TFT_eSPI / TFT_eSprite the firmware
+// uses, so the widgets can be built and measured on a host.
+//
+// The panel keeps an RGB565 frame buffer. Every drawing call is counted, as
+// are the pixels it writes and, for the panel only, the bytes the same call
+// would put on the SPI bus. Addressing a window costs HEADLESS_WINDOW_BYTES
+// and each pixel costs HEADLESS_PIXEL_BYTES, the same model SpanPush uses.
+// Filled primitives open one window, lines one window per straight run and
+// circles one window per pixel, roughly like the real library.
+//
+// Sprites follow TFT_eSprite: 16-bit sprites are stored byte-swapped and
+// getPointer() exposes them, 8-bit sprites take RGB565 and keep RGB332,
+// 4-bit sprites take palette indices and 1-bit sprites take set/clear.
+//
+// Text uses a made-up glyph per character at the real fonts' cell sizes, so
+// where text lands and what it costs are right but it does not look right.
+
+#include "Arduino.h"
+
+#define TFT_BLACK       0x0000
+#define TFT_NAVY        0x000F
+#define TFT_DARKGREEN   0x03E0
+#define TFT_DARKCYAN    0x03EF
+#define TFT_MAROON      0x7800
+#define TFT_PURPLE      0x780F
+#define TFT_OLIVE       0x7BE0
+#define TFT_LIGHTGREY   0xD69A
+#define TFT_DARKGREY    0x7BEF
+#define TFT_BLUE        0x001F
+#define TFT_GREEN       0x07E0
+#define TFT_CYAN        0x07FF
+#define TFT_RED         0xF800
+#define TFT_MAGENTA     0xF81F
+#define TFT_YELLOW      0xFFE0
+#define TFT_WHITE       0xFFFF
+#define TFT_ORANGE      0xFDA0
+#define TFT_GREENYELLOW 0xB7E0
+#define TFT_PINK        0xFE19
+#define TFT_BROWN       0x9A60
+
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define MC_DATUM 4
+#define MR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+
+#define TFT_BL 0
+
+#if defined(ILI9488_DRIVER)
+#define HEADLESS_PIXEL_BYTES 3u
+#else
+#define HEADLESS_PIXEL_BYTES 2u
+#endif
+#define HEADLESS_WINDOW_BYTES 11u
+
+struct HeadlessStats {
+    uint32_t calls;     // drawing and pushing calls made
+    uint32_t pixels;    // pixels written
+    uint32_t windows;   // panel windows addressed
+    uint32_t bytes;     // SPI-equivalent bytes sent to the panel
+};
+
+// Drawing into any sprite is also added up here, since the widgets' and the
+// compositor's sprites are not reachable from outside.
+extern HeadlessStats headlessSpriteStats;
+
+class TFT_eSPI {
+public:
+    TFT_eSPI(int16_t _w = 320, int16_t _h = 480);
+    virtual ~TFT_eSPI();
+
+    void init() {}
+    void setRotation(uint8_t r);
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+    void fillScreen(uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color);
+
+    void setTextColor(uint16_t fg) { textFg = fg; textBg = fg; }
+    void setTextColor(uint16_t fg, uint16_t bg, bool = false) { textFg = fg; textBg = bg; }
+    void setTextDatum(uint8_t d) { textDatum = d; }
+    int16_t drawString(const char* s, int32_t x, int32_t y, uint8_t font);
+    int16_t drawString(const char* s, int32_t x, int32_t y) { return drawString(s, x, y, 1); }
+    int16_t textWidth(const char* s, uint8_t font = 1);
+    int16_t fontHeight(int16_t font = 1);
+
+    void startWrite() {}
+    void endWrite() {}
+    void setSwapBytes(bool swap) { swapBytes = swap; }
+    bool getSwapBytes() const { return swapBytes; }
+    void setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+    void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) { setWindow(x, y, x + w - 1, y + h - 1); }
+    void pushBlock(uint16_t color, uint32_t len);
+    void pushPixels(const void* data, uint32_t len);
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data);
+
+    // Host-only: inspect and dump what the panel shows.
+    HeadlessStats stats;
+    void resetStats() { memset(&stats, 0, sizeof(stats)); }
+    uint16_t pixelAt(int32_t x, int32_t y) const;
+    uint64_t frameHash() const;
+    bool savePPM(const char* path) const;
+
+protected:
+    // One colour argument as stored in this surface's memory.
+    virtual uint16_t encode(uint32_t color) const { return (uint16_t)color; }
+    // What a stored value looks like on the panel, as RGB565.
+    virtual uint16_t decode(uint16_t raw) const { return raw; }
+    virtual bool isPanel() const { return true; }
+
+    // Clipped spans; each one is a window on the panel.
+    void hspan(int32_t x, int32_t y, int32_t len, uint32_t color);
+    void vspan(int32_t x, int32_t y, int32_t len, uint32_t color);
+    void plot(int32_t x, int32_t y, uint32_t color) { hspan(x, y, 1, color); }
+    void account(uint32_t pixels, uint32_t windows);
+    void countCall();
+    void store(int32_t x, int32_t y, uint16_t raw) {
+        if (x >= 0 && y >= 0 && x < _width && y < _height) buffer[y * _width + x] = raw;
+    }
+
+    uint16_t* buffer;
+    int16_t _width, _height;
+
+private:
+    uint16_t textFg, textBg;
+    uint8_t textDatum;
+    bool swapBytes;
+
+    // Open window for pushBlock/pushPixels.
+    int32_t winX0, winY0, winX1, winY1, winX, winY;
+
+    void windowWrite(uint16_t rgb565);
+    void drawGlyph(char c, int32_t x, int32_t y, uint8_t font);
+};
+
+class TFT_eSprite : public TFT_eSPI {
+public:
+    explicit TFT_eSprite(TFT_eSPI* _parent);
+    ~TFT_eSprite();
+
+    void* createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+    void deleteSprite();
+    bool created() const { return buffer != nullptr; }
+
+    void* setColorDepth(int8_t depth);
+    int8_t getColorDepth() const { return colorDepth; }
+    void createPalette(const uint16_t* colors = nullptr, uint8_t count = 16);
+    void setBitmapColor(uint16_t fg, uint16_t bg) { bitmapFg = fg; bitmapBg = bg; }
+
+    void fillSprite(uint32_t color) { fillRect(0, 0, _width, _height, color); }
+    void setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color = TFT_BLACK);
+    void scroll(int16_t dx, int16_t dy = 0);
+
+    void pushSprite(int32_t x, int32_t y);
+    void pushSprite(int32_t x, int32_t y, uint16_t transparent);
+    void* getPointer() { return buffer; }
+    uint16_t readPixel(int32_t x, int32_t y) const;
+
+protected:
+    uint16_t encode(uint32_t color) const override;
+    uint16_t decode(uint16_t raw) const override;
+    bool isPanel() const override { return false; }
+
+private:
+    TFT_eSPI* parent;
+    int8_t colorDepth;
+    uint16_t palette[16];
+    uint16_t bitmapFg, bitmapBg;
+    int32_t scrollX, scrollY, scrollW, scrollH;
+    uint16_t scrollFill;
+
+    void pushTo(int32_t x, int32_t y, bool skip, uint16_t transparent);
+};
+
+#endif
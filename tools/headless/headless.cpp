@@ -0,0 +1,612 @@
+#include "Arduino.h"
+#include "TFT_eSPI.h"
+
+#include <chrono>
+#include <thread>
+
+// ================= ARDUINO =================
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+HardwareSerial Serial2;
+RP2040Host rp2040;
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+static uint32_t randomState = 1u;
+static bool simulatedClock = false;
+static uint64_t simulatedUs = 0u;
+
+static uint64_t nowUs() {
+    if (simulatedClock) return simulatedUs;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long millis() {
+    return (unsigned long)(nowUs() / 1000u);
+}
+
+unsigned long micros() {
+    return (unsigned long)nowUs();
+}
+
+// 8N1: ten bit times per byte.
+int HardwareSerial::availableForWrite() {
+    if (txBaud == 0u) return 256;
+    uint64_t now = nowUs() * 1000u;
+    if (txIdleAtNs <= now) return HEADLESS_UART_FIFO;
+    uint64_t byteNs = 10000000000ull / txBaud;
+    uint64_t queued = (txIdleAtNs - now + byteNs - 1u) / byteNs;
+    return (queued >= HEADLESS_UART_FIFO) ? 0 : (int)(HEADLESS_UART_FIFO - queued);
+}
+
+size_t HardwareSerial::write(const uint8_t*, size_t len) {
+    txBytes += len;
+    if (txBaud != 0u) {
+        uint64_t now = nowUs() * 1000u;
+        if (txIdleAtNs < now) txIdleAtNs = now;
+        txIdleAtNs += (uint64_t)len * (10000000000ull / txBaud);
+    }
+    return len;
+}
+
+void delay(unsigned long ms) {
+    if (simulatedClock) {
+        simulatedUs += (uint64_t)ms * 1000u;
+        return;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void headlessSetMicros(uint64_t us) {
+    simulatedClock = true;
+    simulatedUs = us;
+}
+
+uint32_t RP2040Host::getCycleCount() {
+    return (uint32_t)((uint64_t)micros() * (f_cpu() / 1000000u));
+}
+
+// Fixed LCG so runs are repeatable unless randomSeed() says otherwise.
+long random(long max) {
+    if (max <= 0) return 0;
+    randomState = randomState * 1664525u + 1013904223u;
+    return (long)((randomState >> 8) % (uint32_t)max);
+}
+
+long random(long min, long max) {
+    if (max <= min) return min;
+    return min + random(max - min);
+}
+
+void randomSeed(unsigned long seed) {
+    randomState = (uint32_t)seed;
+}
+
+// ================= PANEL =================
+
+HeadlessStats headlessSpriteStats;
+
+TFT_eSPI::TFT_eSPI(int16_t _w, int16_t _h)
+    : buffer(nullptr), _width(_w), _height(_h), textFg(TFT_WHITE), textBg(TFT_WHITE),
+      textDatum(TL_DATUM), swapBytes(false), winX0(0), winY0(0), winX1(-1), winY1(-1), winX(0), winY(0) {
+    memset(&stats, 0, sizeof(stats));
+    if (_w > 0 && _h > 0) {
+        buffer = new uint16_t[(size_t)_w * _h];
+        memset(buffer, 0, (size_t)_w * _h * sizeof(uint16_t));
+    }
+}
+
+// Sprites release their own buffer before this runs.
+TFT_eSPI::~TFT_eSPI() {
+    delete[] buffer;
+}
+
+void TFT_eSPI::setRotation(uint8_t r) {
+    bool landscape = (r & 1u) != 0;
+    int16_t lo = (_width < _height) ? _width : _height;
+    int16_t hi = (_width < _height) ? _height : _width;
+    _width = landscape ? hi : lo;
+    _height = landscape ? lo : hi;
+}
+
+void TFT_eSPI::countCall() {
+    stats.calls++;
+    if (!isPanel()) headlessSpriteStats.calls++;
+}
+
+void TFT_eSPI::account(uint32_t pixels, uint32_t windows) {
+    if (isPanel()) {
+        stats.pixels += pixels;
+        stats.windows += windows;
+        stats.bytes += windows * HEADLESS_WINDOW_BYTES + pixels * HEADLESS_PIXEL_BYTES;
+    } else {
+        stats.pixels += pixels;
+        headlessSpriteStats.pixels += pixels;
+    }
+}
+
+void TFT_eSPI::hspan(int32_t x, int32_t y, int32_t len, uint32_t color) {
+    if (buffer == nullptr || y < 0 || y >= _height) return;
+    if (x < 0) { len += x; x = 0; }
+    if (x + len > _width) len = _width - x;
+    if (len <= 0) return;
+
+    uint16_t raw = encode(color);
+    uint16_t* p = buffer + (size_t)y * _width + x;
+    for (int32_t i = 0; i < len; i++) p[i] = raw;
+    account((uint32_t)len, 1u);
+}
+
+void TFT_eSPI::vspan(int32_t x, int32_t y, int32_t len, uint32_t color) {
+    if (buffer == nullptr || x < 0 || x >= _width) return;
+    if (y < 0) { len += y; y = 0; }
+    if (y + len > _height) len = _height - y;
+    if (len <= 0) return;
+
+    uint16_t raw = encode(color);
+    uint16_t* p = buffer + (size_t)y * _width + x;
+    for (int32_t i = 0; i < len; i++) p[(size_t)i * _width] = raw;
+    account((uint32_t)len, 1u);
+}
+
+void TFT_eSPI::fillScreen(uint32_t color) {
+    fillRect(0, 0, _width, _height, color);
+}
+
+void TFT_eSPI::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    countCall();
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > _width) w = _width - x;
+    if (y + h > _height) h = _height - y;
+    if (w <= 0 || h <= 0 || buffer == nullptr) return;
+
+    uint16_t raw = encode(color);
+    for (int32_t r = 0; r < h; r++) {
+        uint16_t* p = buffer + (size_t)(y + r) * _width + x;
+        for (int32_t i = 0; i < w; i++) p[i] = raw;
+    }
+    account((uint32_t)(w * h), 1u);
+}
+
+void TFT_eSPI::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color) {
+    countCall();
+    if (w <= 0 || h <= 0) return;
+    hspan(x, y, w, color);
+    if (h > 1) hspan(x, y + h - 1, w, color);
+    if (h > 2) {
+        vspan(x, y + 1, h - 2, color);
+        if (w > 1) vspan(x + w - 1, y + 1, h - 2, color);
+    }
+}
+
+void TFT_eSPI::drawPixel(int32_t x, int32_t y, uint32_t color) {
+    countCall();
+    plot(x, y, color);
+}
+
+void TFT_eSPI::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color) {
+    countCall();
+    hspan(x, y, w, color);
+}
+
+void TFT_eSPI::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color) {
+    countCall();
+    vspan(x, y, h, color);
+}
+
+// Bresenham, emitting each straight run along the major axis as one span.
+void TFT_eSPI::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+    countCall();
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) {
+        int32_t t = x0; x0 = y0; y0 = t;
+        t = x1; x1 = y1; y1 = t;
+    }
+    if (x0 > x1) {
+        int32_t t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    int32_t dx = x1 - x0;
+    int32_t dy = abs(y1 - y0);
+    int32_t err = dx >> 1;
+    int32_t ystep = (y0 < y1) ? 1 : -1;
+    int32_t runStart = x0;
+
+    for (int32_t x = x0; x <= x1; x++) {
+        err -= dy;
+        if (err < 0 || x == x1) {
+            int32_t len = x - runStart + 1;
+            if (steep) vspan(y0, runStart, len, color);
+            else hspan(runStart, y0, len, color);
+            if (err < 0) {
+                y0 += ystep;
+                err += dx;
+            }
+            runStart = x + 1;
+        }
+    }
+}
+
+void TFT_eSPI::drawCircle(int32_t x0, int32_t y0, int32_t r, uint32_t color) {
+    countCall();
+    if (r < 0) return;
+
+    int32_t f = 1 - r;
+    int32_t ddx = 1;
+    int32_t ddy = -2 * r;
+    int32_t x = 0;
+    int32_t y = r;
+
+    plot(x0, y0 + r, color);
+    plot(x0, y0 - r, color);
+    plot(x0 + r, y0, color);
+    plot(x0 - r, y0, color);
+
+    while (x < y) {
+        if (f >= 0) {
+            y--;
+            ddy += 2;
+            f += ddy;
+        }
+        x++;
+        ddx += 2;
+        f += ddx;
+
+        plot(x0 + x, y0 + y, color);
+        plot(x0 - x, y0 + y, color);
+        plot(x0 + x, y0 - y, color);
+        plot(x0 - x, y0 - y, color);
+        if (x != y) {
+            plot(x0 + y, y0 + x, color);
+            plot(x0 - y, y0 + x, color);
+            plot(x0 + y, y0 - x, color);
+            plot(x0 - y, y0 - x, color);
+        }
+    }
+}
+
+// ================= TEXT =================
+
+struct HeadlessFont {
+    uint8_t cellW, cellH;   // character cell
+    uint8_t sx, sy;         // glyph scale
+};
+
+static HeadlessFont fontFor(uint8_t font) {
+    switch (font) {
+        case 2:  return { 8, 16, 1, 2 };
+        case 4:  return { 14, 26, 2, 3 };
+        case 6:
+        case 7:  return { 32, 48, 5, 6 };
+        case 8:  return { 55, 75, 10, 10 };
+        default: return { 6, 8, 1, 1 };
+    }
+}
+
+// A 5x7 pattern derived from the character code; blank for space.
+static uint8_t glyphColumn(char c, uint8_t col) {
+    if (c == ' ' || col >= 5) return 0;
+    uint32_t h = ((uint32_t)(uint8_t)c + 1u) * 2654435761u;
+    return (uint8_t)((h >> (col * 5u + 3u)) & 0x7Fu);
+}
+
+int16_t TFT_eSPI::textWidth(const char* s, uint8_t font) {
+    return (s == nullptr) ? 0 : (int16_t)(strlen(s) * fontFor(font).cellW);
+}
+
+int16_t TFT_eSPI::fontHeight(int16_t font) {
+    return fontFor((uint8_t)font).cellH;
+}
+
+void TFT_eSPI::drawGlyph(char c, int32_t x, int32_t y, uint8_t font) {
+    HeadlessFont f = fontFor(font);
+    int32_t gx = x + (f.cellW - 5 * f.sx) / 2;
+    int32_t gy = y + (f.cellH - 7 * f.sy) / 2;
+
+    // Opaque text goes out as one window per cell; transparent text as one
+    // small fill per set dot.
+    if (textBg != textFg) {
+        for (int32_t r = 0; r < f.cellH; r++) {
+            for (int32_t i = 0; i < f.cellW; i++) {
+                int32_t col = (i - (gx - x)) / f.sx;
+                int32_t row = (r - (gy - y)) / f.sy;
+                bool on = i >= gx - x && r >= gy - y && col < 5 && row < 7 &&
+                          (glyphColumn(c, (uint8_t)col) >> row) & 1u;
+                store(x + i, y + r, encode(on ? textFg : textBg));
+            }
+        }
+        account((uint32_t)f.cellW * f.cellH, 1u);
+        return;
+    }
+
+    for (uint8_t col = 0; col < 5; col++) {
+        uint8_t bits = glyphColumn(c, col);
+        for (uint8_t row = 0; row < 7; row++) {
+            if (!((bits >> row) & 1u)) continue;
+            for (uint8_t j = 0; j < f.sy; j++) {
+                hspan(gx + col * f.sx, gy + row * f.sy + j, f.sx, textFg);
+            }
+        }
+    }
+}
+
+int16_t TFT_eSPI::drawString(const char* s, int32_t x, int32_t y, uint8_t font) {
+    countCall();
+    if (s == nullptr) return 0;
+
+    HeadlessFont f = fontFor(font);
+    int32_t w = (int32_t)strlen(s) * f.cellW;
+    int32_t h = f.cellH;
+
+    switch (textDatum % 3) {
+        case 1: x -= w / 2; break;
+        case 2: x -= w; break;
+        default: break;
+    }
+    switch (textDatum / 3) {
+        case 1: y -= h / 2; break;
+        case 2: y -= h; break;
+        default: break;
+    }
+
+    for (const char* p = s; *p != '\0'; p++) {
+        drawGlyph(*p, x, y, font);
+        x += f.cellW;
+    }
+    return (int16_t)w;
+}
+
+// ================= WINDOWED WRITES =================
+
+void TFT_eSPI::setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+    countCall();
+    winX0 = x0;
+    winY0 = y0;
+    winX1 = x1;
+    winY1 = y1;
+    winX = x0;
+    winY = y0;
+    account(0u, 1u);
+}
+
+void TFT_eSPI::windowWrite(uint16_t rgb565) {
+    store(winX, winY, encode(rgb565));
+    if (++winX > winX1) {
+        winX = winX0;
+        if (++winY > winY1) winY = winY0;
+    }
+}
+
+void TFT_eSPI::pushBlock(uint16_t color, uint32_t len) {
+    countCall();
+    for (uint32_t i = 0; i < len; i++) windowWrite(color);
+    account(len, 0u);
+}
+
+// Without swapBytes the data is already in wire order (high byte first in
+// memory), which is how 16-bit sprites store it.
+void TFT_eSPI::pushPixels(const void* data, uint32_t len) {
+    countCall();
+    const uint16_t* px = (const uint16_t*)data;
+    for (uint32_t i = 0; i < len; i++) {
+        uint16_t c = px[i];
+        windowWrite(swapBytes ? c : (uint16_t)((c >> 8) | (c << 8)));
+    }
+    account(len, 0u);
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t* data) {
+    if (w <= 0 || h <= 0 || data == nullptr) return;
+    setWindow(x, y, x + w - 1, y + h - 1);
+    pushPixels(data, (uint32_t)(w * h));
+}
+
+// ================= INSPECTION =================
+
+uint16_t TFT_eSPI::pixelAt(int32_t x, int32_t y) const {
+    if (buffer == nullptr || x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+    return decode(buffer[(size_t)y * _width + x]);
+}
+
+// FNV-1a over the RGB565 image, row by row.
+uint64_t TFT_eSPI::frameHash() const {
+    uint64_t hash = 14695981039346656037ull;
+    for (int32_t y = 0; y < _height; y++) {
+        for (int32_t x = 0; x < _width; x++) {
+            uint16_t c = pixelAt(x, y);
+            hash = (hash ^ (c & 0xFFu)) * 1099511628211ull;
+            hash = (hash ^ (c >> 8)) * 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+bool TFT_eSPI::savePPM(const char* path) const {
+    FILE* fp = fopen(path, "wb");
+    if (fp == nullptr) return false;
+
+    fprintf(fp, "P6\n%d %d\n255\n", _width, _height);
+    for (int32_t y = 0; y < _height; y++) {
+        for (int32_t x = 0; x < _width; x++) {
+            uint16_t c = pixelAt(x, y);
+            uint8_t rgb[3] = {
+                (uint8_t)(((c >> 11) & 0x1F) * 255 / 31),
+                (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+                (uint8_t)((c & 0x1F) * 255 / 31)
+            };
+            fwrite(rgb, 1, sizeof(rgb), fp);
+        }
+    }
+    return fclose(fp) == 0;
+}
+
+// ================= SPRITE =================
+
+// TFT_eSPI's default 4-bit palette.
+static const uint16_t defaultPalette[16] = {
+    TFT_BLACK, TFT_BROWN, TFT_RED, TFT_ORANGE, TFT_YELLOW, TFT_GREEN, TFT_BLUE, TFT_PURPLE,
+    TFT_DARKGREY, TFT_WHITE, TFT_CYAN, TFT_MAGENTA, TFT_MAROON, TFT_DARKGREEN, TFT_NAVY, TFT_PINK
+};
+
+TFT_eSprite::TFT_eSprite(TFT_eSPI* _parent)
+    : TFT_eSPI(0, 0), parent(_parent), colorDepth(16), bitmapFg(TFT_WHITE), bitmapBg(TFT_BLACK),
+      scrollX(0), scrollY(0), scrollW(0), scrollH(0), scrollFill(TFT_BLACK) {
+    memcpy(palette, defaultPalette, sizeof(palette));
+}
+
+TFT_eSprite::~TFT_eSprite() {
+    deleteSprite();
+}
+
+void* TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t frames) {
+    (void)frames;
+    deleteSprite();
+    if (w <= 0 || h <= 0) return nullptr;
+
+    buffer = new uint16_t[(size_t)w * h];
+    memset(buffer, 0, (size_t)w * h * sizeof(uint16_t));
+    _width = w;
+    _height = h;
+    scrollX = 0;
+    scrollY = 0;
+    scrollW = w;
+    scrollH = h;
+    return buffer;
+}
+
+void TFT_eSprite::deleteSprite() {
+    delete[] buffer;
+    buffer = nullptr;
+    _width = 0;
+    _height = 0;
+}
+
+void* TFT_eSprite::setColorDepth(int8_t depth) {
+    colorDepth = (depth == 1 || depth == 4 || depth == 8) ? depth : 16;
+    if (buffer != nullptr) return createSprite(_width, _height);
+    return nullptr;
+}
+
+void TFT_eSprite::createPalette(const uint16_t* colors, uint8_t count) {
+    memcpy(palette, defaultPalette, sizeof(palette));
+    if (colors == nullptr) return;
+    if (count > 16) count = 16;
+    for (uint8_t i = 0; i < count; i++) palette[i] = colors[i];
+}
+
+uint16_t TFT_eSprite::encode(uint32_t color) const {
+    uint16_t c = (uint16_t)color;
+    switch (colorDepth) {
+        case 1:  return c ? 1u : 0u;
+        case 4:  return c & 0x0Fu;
+        case 8:  return (uint16_t)(((c & 0xE000u) >> 8) | ((c & 0x0700u) >> 6) | ((c & 0x0018u) >> 3));
+        default: return (uint16_t)((c >> 8) | (c << 8));
+    }
+}
+
+uint16_t TFT_eSprite::decode(uint16_t raw) const {
+    switch (colorDepth) {
+        case 1:  return raw ? bitmapFg : bitmapBg;
+        case 4:  return palette[raw & 0x0Fu];
+        case 8: {
+            uint16_t r = (raw & 0xE0u) >> 5;
+            uint16_t g = (raw & 0x1Cu) >> 2;
+            uint16_t b = raw & 0x03u;
+            return (uint16_t)(((r * 31u / 7u) << 11) | ((g * 63u / 7u) << 5) | (b * 31u / 3u));
+        }
+        default: return (uint16_t)((raw >> 8) | (raw << 8));
+    }
+}
+
+uint16_t TFT_eSprite::readPixel(int32_t x, int32_t y) const {
+    return pixelAt(x, y);
+}
+
+void TFT_eSprite::setScrollRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > _width) w = _width - x;
+    if (y + h > _height) h = _height - y;
+    if (w <= 0 || h <= 0) return;
+
+    scrollX = x;
+    scrollY = y;
+    scrollW = w;
+    scrollH = h;
+    scrollFill = color;
+}
+
+// Moves the scroll rectangle's contents and fills what was uncovered.
+void TFT_eSprite::scroll(int16_t dx, int16_t dy) {
+    countCall();
+    if (buffer == nullptr || (dx == 0 && dy == 0)) return;
+    if (abs(dx) >= scrollW || abs(dy) >= scrollH) {
+        fillRect(scrollX, scrollY, scrollW, scrollH, scrollFill);
+        return;
+    }
+
+    int32_t rows = scrollH - abs(dy);
+    int32_t cols = scrollW - abs(dx);
+    int32_t srcX = scrollX + ((dx < 0) ? -dx : 0);
+    int32_t dstX = scrollX + ((dx > 0) ? dx : 0);
+
+    for (int32_t i = 0; i < rows; i++) {
+        int32_t r = (dy > 0) ? rows - 1 - i : i;
+        int32_t srcY = scrollY + r + ((dy < 0) ? -dy : 0);
+        int32_t dstY = scrollY + r + ((dy > 0) ? dy : 0);
+        memmove(buffer + (size_t)dstY * _width + dstX, buffer + (size_t)srcY * _width + srcX,
+                (size_t)cols * sizeof(uint16_t));
+    }
+    account((uint32_t)(rows * cols), 0u);
+
+    if (dx > 0) fillRect(scrollX, scrollY, dx, scrollH, scrollFill);
+    if (dx < 0) fillRect(scrollX + scrollW + dx, scrollY, -dx, scrollH, scrollFill);
+    if (dy > 0) fillRect(scrollX, scrollY, scrollW, dy, scrollFill);
+    if (dy < 0) fillRect(scrollX, scrollY + scrollH + dy, scrollW, -dy, scrollFill);
+}
+
+// Converts each row to RGB565 and sends it as one window (or, with a
+// transparent colour, one window per opaque run), like the real library.
+void TFT_eSprite::pushTo(int32_t x, int32_t y, bool skip, uint16_t transparent) {
+    countCall();
+    if (buffer == nullptr || parent == nullptr) return;
+
+    bool swap = parent->getSwapBytes();
+    parent->setSwapBytes(true);
+
+    uint16_t* row = new uint16_t[_width];
+    if (!skip) parent->setWindow(x, y, x + _width - 1, y + _height - 1);
+    for (int32_t r = 0; r < _height; r++) {
+        for (int32_t i = 0; i < _width; i++) row[i] = decode(buffer[(size_t)r * _width + i]);
+        if (!skip) {
+            parent->pushPixels(row, (uint32_t)_width);
+            continue;
+        }
+
+        int32_t i = 0;
+        while (i < _width) {
+            while (i < _width && row[i] == transparent) i++;
+            int32_t start = i;
+            while (i < _width && row[i] != transparent) i++;
+            if (i > start) {
+                parent->setWindow(x + start, y + r, x + i - 1, y + r);
+                parent->pushPixels(row + start, (uint32_t)(i - start));
+            }
+        }
+    }
+    delete[] row;
+
+    parent->setSwapBytes(swap);
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y) {
+    pushTo(x, y, false, 0);
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transparent) {
+    pushTo(x, y, true, transparent);
+}
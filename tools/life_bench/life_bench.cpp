@@ -0,0 +1,175 @@
+// Host benchmark for the startup animation's Life kernel (lib/Life), built
+// by the native_life_bench env in platformio.ini.
+//
+// Runs LifeGrid next to the byte-per-cell loop the animation used before,
+// checks that every generation matches, and reports generations per second
+// for each. It also counts the fillRect calls a frame costs: one per changed
+// cell before, one per changed run now. The intro shows a fixed 120
+// generations, so the totals are what boot spends on the animation.
+//
+//   life_bench [--gens N] [--seed N] [--density PERCENT]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "Life.h"
+
+#define BENCH_GENS 2000
+#define BENCH_SEED 1u
+#define BENCH_DENSITY 15        // percent alive at start, as on the device
+#define BENCH_INTRO_GENS 120    // loading bar: 480 px, 4 px per frame
+
+static uint8_t grid[LIFE_ROWS][LIFE_COLS];
+static uint8_t prev[LIFE_ROWS][LIFE_COLS];
+static const int8_t offsets[8][2] = {{-1,-1},{0,-1},{1,-1},{-1,0},{1,0},{-1,1},{0,1},{1,1}};
+
+// The old playStartupAnimation() step, unchanged.
+static void stepReference() {
+    memcpy(prev, grid, sizeof(grid));
+    for (int i = 0; i < LIFE_ROWS; i++) {
+        for (int j = 0; j < LIFE_COLS; j++) {
+            uint8_t living_num = 0;
+            for (int z = 0; z < 8; z++) {
+                int ni = (i + offsets[z][0] + LIFE_ROWS) % LIFE_ROWS;
+                int nj = (j + offsets[z][1] + LIFE_COLS) % LIFE_COLS;
+                if (prev[ni][nj]) living_num++;
+            }
+            if (prev[i][j]) grid[i][j] = (living_num == 2 || living_num == 3);
+            else grid[i][j] = (living_num == 3);
+        }
+    }
+}
+
+static uint32_t changedCells() {
+    uint32_t n = 0;
+    for (int i = 0; i < LIFE_ROWS; i++) {
+        for (int j = 0; j < LIFE_COLS; j++) n += prev[i][j] != grid[i][j];
+    }
+    return n;
+}
+
+// Replays the runs onto a copy of the previous generation, so a run that is
+// misplaced or missing shows up as a mismatch.
+struct RunCheck {
+    uint8_t cells[LIFE_ROWS][LIFE_COLS];
+    uint32_t runs;
+    uint32_t runCells;
+};
+
+static void applyRun(void* ctx, uint16_t row, uint16_t col, uint16_t len, bool alive) {
+    RunCheck* check = (RunCheck*)ctx;
+    for (uint16_t k = 0; k < len; k++) check->cells[row][col + k] = alive ? 1u : 0u;
+    check->runs++;
+    check->runCells += len;
+}
+
+static void countRun(void* ctx, uint16_t row, uint16_t col, uint16_t len, bool alive) {
+    (void)row;
+    (void)col;
+    (void)len;
+    (void)alive;
+    (*(uint32_t*)ctx)++;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: life_bench [--gens N] [--seed N] [--density PERCENT]\n");
+}
+
+static void seed(LifeGrid& life, uint32_t seedValue, uint32_t density) {
+    srand(seedValue);
+    life.clear();
+    for (uint16_t i = 0; i < LIFE_ROWS; i++) {
+        for (uint16_t j = 0; j < LIFE_COLS; j++) {
+            grid[i][j] = (uint32_t)(rand() % 100) < density;
+            life.set(i, j, grid[i][j] != 0u);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t gens = BENCH_GENS;
+    uint32_t seedValue = BENCH_SEED;
+    uint32_t density = BENCH_DENSITY;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--gens") == 0 && hasValue) {
+            gens = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && hasValue) {
+            seedValue = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--density") == 0 && hasValue) {
+            density = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (gens == 0u) {
+        usage();
+        return 2;
+    }
+
+    // Correctness, and draw calls over the intro
+    static LifeGrid life;
+    static RunCheck check;
+    seed(life, seedValue, density);
+    uint64_t cellRects = 0, runRects = 0;
+    uint64_t introCellRects = 0, introRunRects = 0;
+    for (uint32_t g = 0; g < gens; g++) {
+        memcpy(check.cells, grid, sizeof(grid));
+        check.runs = 0;
+        check.runCells = 0;
+
+        stepReference();
+        life.step();
+        life.forEachChangedRun(applyRun, &check);
+
+        uint32_t cells = changedCells();
+        bool same = memcmp(check.cells, grid, sizeof(grid)) == 0 && check.runCells == cells;
+        for (uint16_t i = 0; same && i < LIFE_ROWS; i++) {
+            for (uint16_t j = 0; same && j < LIFE_COLS; j++) same = life.get(i, j) == (grid[i][j] != 0u);
+        }
+        if (!same) {
+            fprintf(stderr, "life_bench: generation %u differs from the reference\n", g + 1u);
+            return 1;
+        }
+        cellRects += cells;
+        runRects += check.runs;
+        if (g < BENCH_INTRO_GENS) {
+            introCellRects += cells;
+            introRunRects += check.runs;
+        }
+    }
+
+    // Timing: step plus diff, as one animation frame does
+    uint32_t sink = 0;
+    seed(life, seedValue, density);
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t g = 0; g < gens; g++) {
+        stepReference();
+        sink += changedCells();
+    }
+    double refNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / gens;
+
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t g = 0; g < gens; g++) {
+        life.step();
+        life.forEachChangedRun(countRun, &sink);
+    }
+    double lifeNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / gens;
+
+    printf("%ux%u torus, %u generations, %u%% seeded, population %u at the end\n", (unsigned)LIFE_COLS,
+           (unsigned)LIFE_ROWS, gens, density, life.population());
+    printf("LifeGrid   %10.0f gen/s  %8.1f us/gen\n", 1e9 / lifeNs, lifeNs / 1000.0);
+    printf("reference  %10.0f gen/s  %8.1f us/gen  (x%.1f)\n", 1e9 / refNs, refNs / 1000.0,
+           lifeNs > 0 ? refNs / lifeNs : 0.0);
+    printf("fillRect   %8.1f runs/gen vs %8.1f cells/gen\n", (double)runRects / gens, (double)cellRects / gens);
+    printf("intro      %llu runs vs %llu cells over %u generations\n", (unsigned long long)introRunRects,
+           (unsigned long long)introCellRects, gens < BENCH_INTRO_GENS ? gens : (uint32_t)BENCH_INTRO_GENS);
+    printf("checksum   %u\n", sink);
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Host check of the cross-core mailbox (lib/Mailbox), built by the
+// native_mailbox_bench env in platformio.ini.
+//
+// A producer thread publishes LinkScan values as fast as it can, the way the
+// link core does, each one stamped with its sequence number in every field
+// that can carry it. A consumer thread fetches them as the render core does.
+// Every value fetched must carry one stamp throughout (a torn value mixes
+// two publishes) and stamps must only go forwards. Exits 1 if not.
+//
+//   mailbox_bench [--values N]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Mailbox.h"
+#include "link.h"
+
+#define BENCH_VALUES 20000000u
+
+static LatestMailbox<LinkScan> box;
+static std::atomic<bool> producerDone(false);
+
+static void stamp(LinkScan& scan, uint32_t seq) {
+    for (uint16_t& d : scan.distances) d = (uint16_t)seq;
+    scan.sensor = (uint8_t)seq;
+    scan.coverage = (uint16_t)(seq >> 16);
+    scan.seq = seq;
+    scan.updatedMs = ~seq;
+    scan.publishedUs = seq * 2654435761u;
+}
+
+static bool whole(const LinkScan& scan) {
+    uint32_t seq = scan.seq;
+    for (uint16_t d : scan.distances) {
+        if (d != (uint16_t)seq) return false;
+    }
+    return scan.sensor == (uint8_t)seq && scan.coverage == (uint16_t)(seq >> 16) && scan.updatedMs == ~seq &&
+           scan.publishedUs == seq * 2654435761u;
+}
+
+struct ConsumerResult {
+    uint64_t fetched;
+    uint64_t torn;
+    uint64_t backwards;
+    uint32_t last;
+};
+
+static void produce(uint32_t values) {
+    for (uint32_t seq = 1u; seq <= values; seq++) {
+        stamp(box.writeSlot(), seq);
+        box.publish();
+    }
+    producerDone.store(true, std::memory_order_release);
+}
+
+static void consume(ConsumerResult* r) {
+    for (;;) {
+        bool done = producerDone.load(std::memory_order_acquire);
+        const LinkScan* scan = box.fetch();
+        if (scan != nullptr) {
+            r->fetched++;
+            if (!whole(*scan)) r->torn++;
+            if (scan->seq <= r->last) r->backwards++;
+            r->last = scan->seq;
+        } else if (done) {
+            return;
+        }
+    }
+}
+
+static void usage() {
+    fprintf(stderr, "usage: mailbox_bench [--values N]\n");
+}
+
+int main(int argc, char** argv) {
+    uint32_t values = BENCH_VALUES;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--values") == 0 && i + 1 < argc) {
+            values = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (values == 0u) {
+        usage();
+        return 2;
+    }
+
+    ConsumerResult result = {};
+    auto t0 = std::chrono::steady_clock::now();
+    std::thread consumer(consume, &result);
+    std::thread producer(produce, values);
+    producer.join();
+    consumer.join();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    bool ok = result.torn == 0u && result.backwards == 0u && result.last == values;
+    printf("%u values of %u B published in %.2f s (%.1f ns each)\n", values, (unsigned)sizeof(LinkScan), s,
+           s * 1e9 / values);
+    printf("fetched    %llu (%.1f%%), last seq %u\n", (unsigned long long)result.fetched,
+           result.fetched * 100.0 / values, result.last);
+    printf("torn       %llu, backwards %llu  %s\n", (unsigned long long)result.torn,
+           (unsigned long long)result.backwards, ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,374 @@
+// Record and replay OGOA captures (format in lib/ogoa/ogoa_capture.h).
+//
+//   ogoa_cap record [--baud N] <device|-> <out.ogcap>
+//       Tap a serial port, pipe or stdin and store everything read from it
+//       as received bytes, until EOF or Ctrl-C.
+//
+//   ogoa_cap replay [--realtime] [--loops N] [--trace N] <in.ogcap>
+//       mmap a capture and push its received bytes through the display's
+//       own link code (src/link.cpp: ogoa_process_byte, ogoaOnFrame, the
+//       scan and status mailboxes) on the headless Arduino core. By default
+//       it runs as fast as possible on a simulated clock that follows the
+//       capture's timestamps, so results do not depend on the host; with
+//       --realtime it sleeps to the recorded timing on the real clock.
+//       Built with PROFILER_ENABLED=1 (native_ogoa_cap_profile) it also
+//       prints the link core's stage timings, e.g. the per-scan cost of the
+//       proximity and time-to-collision updates. --trace N decodes the last
+//       N records of the link's event trace (at most TRACE_RECORDS - 1).
+//
+// Built by the native_ogoa_cap env in platformio.ini.
+
+#include <Arduino.h>
+
+#include <chrono>
+#include <thread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "Profiler.h"
+#include "link.h"
+#include "ogoa_capture.h"
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+static uint64_t monotonicUs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static speed_t baudConstant(unsigned long baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default: return B0;
+    }
+}
+
+// ================= RECORD =================
+
+static int record(const char* device, const char* outPath, unsigned long baud) {
+    int fd = (strcmp(device, "-") == 0) ? STDIN_FILENO : open(device, O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+        fprintf(stderr, "ogoa_cap: cannot open %s: %s\n", device, strerror(errno));
+        return 1;
+    }
+    if (isatty(fd)) {
+        termios tio;
+        speed_t speed = baudConstant(baud);
+        if (speed == B0 || tcgetattr(fd, &tio) != 0) {
+            fprintf(stderr, "ogoa_cap: cannot set %s to %lu baud\n", device, baud);
+            return 1;
+        }
+        cfmakeraw(&tio);
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+
+    FILE* out = fopen(outPath, "wb");
+    if (out == nullptr) {
+        fprintf(stderr, "ogoa_cap: cannot write %s\n", outPath);
+        return 1;
+    }
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    uint8_t header[OGOA_CAPTURE_HEADER_BYTES];
+    fwrite(header, 1, ogoa_capture_header((uint32_t)time(nullptr), header), out);
+
+    ogoa_capture_writer_t writer = {};
+    uint8_t chunk[OGOA_CAPTURE_CHUNK_MAX];
+    uint8_t rec[OGOA_CAPTURE_RECORD_MAX];
+    uint64_t start = monotonicUs();
+    uint64_t total = 0;
+
+    while (!stopRequested) {
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "ogoa_cap: read failed: %s\n", strerror(errno));
+            break;
+        }
+        uint32_t nowUs = (uint32_t)(monotonicUs() - start);
+        fwrite(rec, 1, ogoa_capture_record(&writer, OGOA_CAPTURE_RX, nowUs, chunk, (size_t)n, rec), out);
+        total += (uint64_t)n;
+    }
+
+    fclose(out);
+    fprintf(stderr, "ogoa_cap: %llu bytes in %.1f s -> %s\n", (unsigned long long)total,
+            (monotonicUs() - start) / 1e6, outPath);
+    return 0;
+}
+
+// ================= REPLAY =================
+
+struct ReplayTotals {
+    uint64_t records;
+    uint64_t rxBytes;
+    uint64_t capturedTxBytes;
+    uint64_t scans[LINK_SENSORS];
+    uint64_t warnings[COLLISION_LEVELS];   // level changes taken, by new level
+    uint64_t durationUs;    // capture time covered
+};
+
+static uint64_t scanHash(const LinkScan& scan) {
+    uint64_t hash = 14695981039346656037ull;
+    for (uint16_t i = 0; i < LINK_SCAN_BINS; i++) {
+        hash = (hash ^ (scan.distances[i] & 0xFFu)) * 1099511628211ull;
+        hash = (hash ^ (scan.distances[i] >> 8)) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// The link core loops continuously between bytes, which is when the debug
+// log drains. On the simulated clock, stand in for those loops: step through
+// the gap one UART FIFO's worth of time at a time and let the log fill it.
+#define REPLAY_LOG_STEP_US 2000u
+
+static void idleLink(uint64_t fromUs, uint64_t toUs) {
+    for (uint64_t t = fromUs + REPLAY_LOG_STEP_US; t < toUs; t += REPLAY_LOG_STEP_US) {
+        headlessSetMicros(t);
+        while (linkLog.poll() > 0u) {}
+    }
+}
+
+static int replayOnce(const uint8_t* data, size_t len, bool realtime, uint64_t timeBase, ReplayTotals& totals,
+                      LinkScan* lastScan) {
+    ogoa_capture_reader_t reader;
+    if (ogoa_capture_open(&reader, data, len) != OGOA_OK) {
+        fprintf(stderr, "ogoa_cap: not an OGOA capture\n");
+        return 1;
+    }
+
+    uint64_t wallStart = monotonicUs();
+    uint64_t lastUs = timeBase;
+    ogoa_capture_record_t rec;
+    int rc;
+    while ((rc = ogoa_capture_next(&reader, &rec)) == 1 && !stopRequested) {
+        totals.records++;
+        totals.durationUs = timeBase + rec.t_us;
+        if (rec.dir == OGOA_CAPTURE_TX) {
+            totals.capturedTxBytes += rec.len;
+            continue;
+        }
+
+        if (realtime) {
+            uint64_t due = wallStart + rec.t_us;
+            uint64_t now = monotonicUs();
+            if (due > now) std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+        } else {
+            idleLink(lastUs, timeBase + rec.t_us);
+            headlessSetMicros(timeBase + rec.t_us);
+            lastUs = timeBase + rec.t_us;
+        }
+
+        Serial.feed(rec.bytes, rec.len);
+        linkLoop();
+        totals.rxBytes += rec.len;
+
+        // Stand in for core0 taking the scans.
+        for (uint8_t s = 0; s < LINK_SENSORS; s++) {
+            const LinkScan* scan = linkScanBox[s].fetch();
+            if (scan != nullptr) {
+                lastScan[s] = *scan;
+                totals.scans[s]++;
+            }
+        }
+        const LinkWarning* warn = linkWarningBox.fetch();
+        if (warn != nullptr) {
+            totals.warnings[warn->level]++;
+        }
+    }
+    if (rc < 0) {
+        fprintf(stderr, "ogoa_cap: capture truncated after %llu records\n", (unsigned long long)totals.records);
+        return 1;
+    }
+    return 0;
+}
+
+// Newest last, timestamps relative to the newest.
+static void printTrace(uint32_t last) {
+    uint32_t count = linkTrace.count();
+    if (last > count) last = count;
+    if (last > TRACE_RECORDS - 1u) last = TRACE_RECORDS - 1u;
+
+    TraceRecord newest;
+    if (last == 0u || !linkTrace.read(count - 1u, &newest)) return;
+    for (uint32_t n = count - last; n != count; n++) {
+        TraceRecord rec;
+        char text[LINK_EVENT_CHARS];
+        if (!linkTrace.read(n, &rec)) continue;
+        linkTraceFormat(rec, text, sizeof(text));
+        printf("  %10lu  %+11.3f ms  %s\n", (unsigned long)n, (double)(int32_t)(rec.us - newest.us) / 1000.0, text);
+    }
+}
+
+static int replay(const char* path, bool realtime, uint32_t loops, uint32_t traceLast) {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        fprintf(stderr, "ogoa_cap: cannot open %s\n", path);
+        return 1;
+    }
+    size_t len = (size_t)st.st_size;
+    void* map = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "ogoa_cap: cannot map %s\n", path);
+        return 1;
+    }
+    madvise(map, len, MADV_SEQUENTIAL);
+
+    signal(SIGINT, onSignal);
+    if (!realtime) headlessSetMicros(0u);
+    linkSetup();
+
+    ReplayTotals totals = {};
+    LinkScan lastScan[LINK_SENSORS] = {};
+    auto t0 = std::chrono::steady_clock::now();
+    int rc = 0;
+    for (uint32_t i = 0; i < loops && rc == 0 && !stopRequested; i++) {
+        rc = replayOnce((const uint8_t*)map, len, realtime, totals.durationUs, totals, lastScan);
+    }
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    munmap(map, len);
+
+    LinkStatus status = {};
+    const LinkStatus* latest = linkStatusBox.fetch();
+    if (latest != nullptr) status = *latest;
+
+    printf("records      %llu\n", (unsigned long long)totals.records);
+    printf("rx bytes     %llu  (%.2f MB/s)\n", (unsigned long long)totals.rxBytes,
+           wallS > 0 ? totals.rxBytes / wallS / 1e6 : 0.0);
+    printf("tx bytes     captured %llu, replayed link sent %llu\n", (unsigned long long)totals.capturedTxBytes,
+           (unsigned long long)Serial.txBytes);
+    printf("tx ring      %u B queued, peak %u of %u B, %lu frames refused\n", (unsigned)status.txQueued,
+           (unsigned)status.txQueuedPeak, (unsigned)OGOA_TX_RING_BYTES, (unsigned long)status.ogoa.tx_busy);
+    printf("link         %lu frames in, %lu out, %lu checksum errors, %lu oversize, %lu duplicates, "
+           "%lu retransmits, %lu status loops\n",
+           (unsigned long)status.ogoa.rx_frames, (unsigned long)status.ogoa.tx_frames,
+           (unsigned long)status.ogoa.checksum_errors, (unsigned long)status.ogoa.oversize_lengths,
+           (unsigned long)status.ogoa.duplicates, (unsigned long)status.ogoa.retransmits,
+           (unsigned long)status.ogoa.status_loops);
+    printf("frames       ack %lu  req %lu  resp %lu  lidar %lu  unknown %lu  short %lu  (%.0f lidar/s)\n",
+           (unsigned long)status.rxAckCount, (unsigned long)status.rxStatusReqCount,
+           (unsigned long)status.rxStatusRespCount, (unsigned long)status.rxLidarCount,
+           (unsigned long)status.rxUnknownCount, (unsigned long)status.rxMalformedCount,
+           wallS > 0 ? status.rxLidarCount / wallS : 0.0);
+    for (uint8_t s = 0; s < LINK_SENSORS; s++) {
+        printf("scans[%u]     %llu taken (%lu complete, %lu partial), last seq %lu, hash %016llx\n", s,
+               (unsigned long long)totals.scans[s], (unsigned long)status.scansComplete[s],
+               (unsigned long)status.scansPartial[s], (unsigned long)lastScan[s].seq,
+               (unsigned long long)scanHash(lastScan[s]));
+        const ProxReport& prox = lastScan[s].prox;
+        printf("  prox       left %u mm, ahead %u mm, right %u mm (%u/%u/%u below %u mm)\n",
+               prox.sectors[LINK_PROX_LEFT].minMm, prox.sectors[LINK_PROX_AHEAD].minMm,
+               prox.sectors[LINK_PROX_RIGHT].minMm, prox.sectors[LINK_PROX_LEFT].belowCount,
+               prox.sectors[LINK_PROX_AHEAD].belowCount, prox.sectors[LINK_PROX_RIGHT].belowCount,
+               LINK_PROX_THRESHOLD_MM);
+        const TtcReport& ttc = lastScan[s].ttc;
+        printf("  ttc        level %u, left %u ms, ahead %u ms, right %u ms\n", ttc.level,
+               ttc.sectors[LINK_PROX_LEFT].ttcMs, ttc.sectors[LINK_PROX_AHEAD].ttcMs,
+               ttc.sectors[LINK_PROX_RIGHT].ttcMs);
+    }
+    printf("warnings     %lu raised (slow %llu, stop %llu, clear %llu), worst chunk check %lu us\n",
+           (unsigned long)status.warningsRaised, (unsigned long long)totals.warnings[COLLISION_SLOW],
+           (unsigned long long)totals.warnings[COLLISION_STOP], (unsigned long long)totals.warnings[COLLISION_CLEAR],
+           (unsigned long)status.warningEvalUsMax);
+#if LINK_WARNING_REPORT
+    printf("  reported   %lu ACKed, %lu lost\n", (unsigned long)status.warningsReported,
+           (unsigned long)status.warningReportsLost);
+#endif
+#if LINK_CAPTURE
+    printf("capture      %llu B to Serial2 (%.0f B/s), %lu records dropped\n", (unsigned long long)Serial2.txBytes,
+           totals.durationUs > 0 ? Serial2.txBytes / (totals.durationUs / 1e6) : 0.0,
+           (unsigned long)status.captureDropped);
+#endif
+#if PROFILER_ENABLED
+    const uint8_t linkStages[] = { PROF_LINK_DRAIN, PROF_LINK_TICK, PROF_PROX, PROF_TTC };
+    for (uint8_t stage : linkStages) {
+        ProfileSummary sum;
+        profilerSummary(stage, &sum);
+        printf("stage %-6s %lu runs, p50 %lu us, p99 %lu us, max %lu us\n", profilerStageName(stage),
+               (unsigned long)sum.count, (unsigned long)sum.p50Us, (unsigned long)sum.p99Us,
+               (unsigned long)sum.maxUs);
+    }
+#endif
+    TraceRecord newest;
+    char event[LINK_EVENT_CHARS] = "-";
+    if (linkTrace.read(linkTrace.count() - 1u, &newest)) linkTraceFormat(newest, event, sizeof(event));
+    printf("trace        %lu events, ring keeps %u (%u B); last: %s\n", (unsigned long)linkTrace.count(),
+           (unsigned)(TRACE_RECORDS - 1u), (unsigned)sizeof(TraceRing), event);
+    printf("debug log    %lu lines, %lu B (%.0f B/s), %lu events dropped\n", (unsigned long)linkLog.lines,
+           (unsigned long)linkLog.bytes, totals.durationUs > 0 ? linkLog.bytes / (totals.durationUs / 1e6) : 0.0,
+           (unsigned long)linkLog.dropped);
+    printTrace(traceLast);
+    printf("time         %.3f s of capture in %.3f s (x%.1f)\n", totals.durationUs / 1e6, wallS,
+           wallS > 0 ? totals.durationUs / 1e6 / wallS : 0.0);
+    return rc;
+}
+
+// ================= MAIN =================
+
+static void usage() {
+    fprintf(stderr, "usage: ogoa_cap record [--baud N] <device|-> <out.ogcap>\n"
+                    "       ogoa_cap replay [--realtime] [--loops N] [--trace N] <in.ogcap>\n");
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+
+    unsigned long baud = 115200;
+    bool realtime = false;
+    uint32_t loops = 1;
+    uint32_t traceLast = 0;
+    const char* args[2] = { nullptr, nullptr };
+    int argCount = 0;
+
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--baud") == 0 && i + 1 < argc) {
+            baud = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--realtime") == 0) {
+            realtime = true;
+        } else if (strcmp(argv[i], "--loops") == 0 && i + 1 < argc) {
+            loops = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            traceLast = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (argCount < 2 && (argv[i][0] != '-' || argv[i][1] == '\0')) {
+            args[argCount++] = argv[i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (strcmp(argv[1], "record") == 0 && argCount == 2) {
+        return record(args[0], args[1], baud);
+    }
+    if (strcmp(argv[1], "replay") == 0 && argCount == 1) {
+        return replay(args[0], realtime, loops, traceLast);
+    }
+    usage();
+    return 2;
+}
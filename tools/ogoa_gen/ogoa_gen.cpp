@@ -0,0 +1,536 @@
+// High-rate OGOA traffic generator: the hallway drive from
+// ogoa_quick_test.py, framed with the real ogoa.c, written to a pty, a pipe
+// or an OGOA capture file.
+//
+//   ogoa_gen [options] --pty | --pipe PATH|- | --capture PATH
+//
+//   --rate HZ        full 360-degree sweeps per second (default 5, 0 = flat out)
+//   --delta DEG      angular step between samples, 1..6 (default 2)
+//   --sensors N      1: front sweeps as LIDAR_SEND (0xAA); 2: front and rear
+//                    sweeps as sequenced LIDAR_SCAN (0xAB) frames (default 1)
+//   --seconds S      scene time to generate (default 10)
+//   --loop S         seconds for one hallway -> corner loop (default 20)
+//   --status-hz HZ   STATUS_RESPONSE frames per second (default 1)
+//   --dropout P      probability of a no-return sample (default 0.01)
+//   --corrupt P      probability a frame gets one bit flipped (default 0)
+//   --garbage P      probability of 1-16 noise bytes before a frame (default 0)
+//   --baud N         link speed used to timestamp captures (default 115200)
+//   --seed N         noise seed (default 1)
+//
+// A pty or pipe is written in real time at --rate (or as fast as it is
+// read with --rate 0). A capture is written as fast as the generator runs,
+// with timestamps from the scene clock, spaced no tighter than --baud allows.
+//
+// Built by the native_ogoa_gen env in platformio.ini.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "ogoa.h"
+#include "ogoa_capture.h"
+
+#define GEN_BINS 360
+#define GEN_POINTS_PER_FRAME 120
+#define GEN_SENSORS_MAX 2
+#define GEN_SCAN_HEADER_BYTES 6u
+#define GEN_SCAN_FLAG_LAST 0x01u
+#define GEN_DRAW_MAX_MM 3800
+#define GEN_NO_RETURN_MM 4095
+#define GEN_MIN_MM 120
+#define GEN_SMOOTH_ALPHA 0.35f
+#define GEN_NOISE_MM 9.0f
+#define GEN_GLITCH_MM 40.0f
+#define GEN_GLITCH_PROB 0.01f
+
+// ================= SCENE =================
+
+struct Wall {
+    float x1, y1, x2, y2;
+};
+
+// Hallway map (mm): L-shaped corridor with a right turn.
+static const Wall walls[] = {
+    { -800.0f, 0.0f, 800.0f, 0.0f },
+    { 800.0f, 0.0f, 800.0f, -8200.0f },
+    { 800.0f, -8200.0f, 9000.0f, -8200.0f },
+    { 9000.0f, -8200.0f, 9000.0f, -9800.0f },
+    { 9000.0f, -9800.0f, -800.0f, -9800.0f },
+    { -800.0f, -9800.0f, -800.0f, 0.0f },
+};
+
+struct Pose {
+    float x, y, headingDeg;
+};
+
+// Straight down the hallway, right turn around the corner, on down the side
+// hallway.
+static Pose poseAt(double t, double loopS) {
+    if (loopS <= 1e-6) loopS = 20.0;
+    double p = fmod(t, loopS) / loopS;
+
+    if (p < 0.55) {
+        double u = p / 0.55;
+        return { 0.0f, (float)(-1200.0 - 7400.0 * u), 0.0f };
+    }
+    if (p < 0.75) {
+        double u = (p - 0.55) / 0.20;
+        return { (float)(1800.0 * u), (float)(-8600.0 - 400.0 * u), (float)(90.0 * u) };
+    }
+    double u = (p - 0.75) / 0.25;
+    return { (float)(1800.0 + 5200.0 * u), -9000.0f, 90.0f };
+}
+
+// All bins are cast together, one wall at a time over contiguous arrays and
+// without branches in the inner loop, so the compiler can vectorise it.
+class RayCaster {
+public:
+    RayCaster() {
+        for (int i = 0; i < GEN_BINS; i++) {
+            double rad = (i - 90.0) * M_PI / 180.0;
+            baseX[i] = (float)cos(rad);
+            baseY[i] = (float)sin(rad);
+        }
+    }
+
+    const float* cast(const Pose& pose) {
+        double h = pose.headingDeg * M_PI / 180.0;
+        float ch = (float)cos(h);
+        float sh = (float)sin(h);
+
+        for (int i = 0; i < GEN_BINS; i++) {
+            dirX[i] = baseX[i] * ch - baseY[i] * sh;
+            dirY[i] = baseX[i] * sh + baseY[i] * ch;
+            nearest[i] = INFINITY;
+        }
+
+        for (const Wall& w : walls) {
+            float sx = w.x2 - w.x1;
+            float sy = w.y2 - w.y1;
+            float qx = w.x1 - pose.x;
+            float qy = w.y1 - pose.y;
+            float qs = qx * sy - qy * sx;
+
+            for (int i = 0; i < GEN_BINS; i++) {
+                float denom = dirX[i] * sy - dirY[i] * sx;
+                bool ok = fabsf(denom) >= 1e-6f;
+                float inv = 1.0f / (ok ? denom : 1.0f);
+                float t = qs * inv;
+                float u = (qx * dirY[i] - qy * dirX[i]) * inv;
+                bool hit = ok && t > 0.0f && u >= 0.0f && u <= 1.0f;
+                float d = hit ? t : INFINITY;
+                nearest[i] = (d < nearest[i]) ? d : nearest[i];
+            }
+        }
+        return nearest;
+    }
+
+private:
+    float baseX[GEN_BINS], baseY[GEN_BINS];
+    float dirX[GEN_BINS], dirY[GEN_BINS];
+    float nearest[GEN_BINS];
+};
+
+// ================= NOISE =================
+
+class Noise {
+public:
+    explicit Noise(uint64_t seed) : state(seed ? seed : 1u) {}
+
+    uint64_t next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    float uniform() { return (float)(next() >> 40) * (1.0f / 16777216.0f); }
+
+    float gauss(float sigma) {
+        float u1 = uniform();
+        float u2 = uniform();
+        if (u1 < 1e-7f) u1 = 1e-7f;
+        return sigma * sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+    }
+
+private:
+    uint64_t state;
+};
+
+// Sensor model from ogoa_quick_test.py: noise, rare glitches, dropouts and
+// per-angle smoothing towards the new reading.
+static void senseSweep(const float* hits, uint16_t* smoothed, float dropout, Noise& noise) {
+    for (int i = 0; i < GEN_BINS; i++) {
+        int raw = isinf(hits[i]) ? GEN_NO_RETURN_MM : (int)hits[i];
+        if (raw < GEN_DRAW_MAX_MM) {
+            raw = (int)(raw + noise.gauss(GEN_NOISE_MM));
+            if (noise.uniform() < GEN_GLITCH_PROB) raw = (int)(raw + noise.gauss(GEN_GLITCH_MM));
+        }
+        if (noise.uniform() < dropout) raw = GEN_NO_RETURN_MM;
+        if (raw < GEN_MIN_MM) raw = GEN_MIN_MM;
+        if (raw > GEN_NO_RETURN_MM) raw = GEN_NO_RETURN_MM;
+
+        int prev = smoothed[i] ? smoothed[i] : GEN_DRAW_MAX_MM;
+        int target = (raw >= GEN_DRAW_MAX_MM) ? GEN_NO_RETURN_MM : raw;
+        int blended = (int)((1.0f - GEN_SMOOTH_ALPHA) * prev + GEN_SMOOTH_ALPHA * target);
+        if (blended < GEN_MIN_MM) blended = GEN_MIN_MM;
+        if (blended > GEN_NO_RETURN_MM) blended = GEN_NO_RETURN_MM;
+        smoothed[i] = (uint16_t)blended;
+    }
+}
+
+// ================= OUTPUT =================
+
+enum OutputKind { OUT_NONE, OUT_PTY, OUT_PIPE, OUT_CAPTURE };
+
+struct Output {
+    OutputKind kind;
+    int fd;
+    FILE* capture;
+    ogoa_capture_writer_t writer;
+    uint64_t wireFreeUs;    // capture: when the simulated line is idle again
+    uint32_t usPerByte10;   // capture: tenths of a microsecond per byte
+    uint64_t bytes;
+    uint64_t readBack;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+static bool openOutput(Output& out, OutputKind kind, const char* path, unsigned long baud) {
+    memset(&out, 0, sizeof(out));
+    out.kind = kind;
+    out.fd = -1;
+    out.usPerByte10 = (uint32_t)(100000000ull / (baud ? baud : 115200u));
+
+    switch (kind) {
+        case OUT_PTY: {
+            out.fd = posix_openpt(O_RDWR | O_NOCTTY);
+            if (out.fd < 0 || grantpt(out.fd) != 0 || unlockpt(out.fd) != 0) return false;
+            termios tio;
+            if (tcgetattr(out.fd, &tio) == 0) {
+                cfmakeraw(&tio);
+                tcsetattr(out.fd, TCSANOW, &tio);
+            }
+            fcntl(out.fd, F_SETFL, fcntl(out.fd, F_GETFL) | O_NONBLOCK);
+            fprintf(stderr, "ogoa_gen: writing to %s\n", ptsname(out.fd));
+            return true;
+        }
+        case OUT_PIPE:
+            out.fd = (strcmp(path, "-") == 0) ? STDOUT_FILENO : open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            return out.fd >= 0;
+        case OUT_CAPTURE: {
+            out.capture = fopen(path, "wb");
+            if (out.capture == nullptr) return false;
+            uint8_t header[OGOA_CAPTURE_HEADER_BYTES];
+            fwrite(header, 1, ogoa_capture_header((uint32_t)time(nullptr), header), out.capture);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+static bool writeAll(int fd, const uint8_t* data, size_t len) {
+    while (len > 0u && !stopRequested) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// Whatever the display sends back (ACKs, status) is read and dropped so the
+// pty never fills up.
+static void drainPty(Output& out) {
+    uint8_t buf[256];
+    ssize_t n;
+    while ((n = read(out.fd, buf, sizeof(buf))) > 0) out.readBack += (uint64_t)n;
+}
+
+static bool emit(Output& out, const uint8_t* data, size_t len, uint64_t sceneUs) {
+    out.bytes += len;
+    if (out.kind != OUT_CAPTURE) {
+        if (out.kind == OUT_PTY) drainPty(out);
+        return writeAll(out.fd, data, len);
+    }
+
+    uint64_t t = (sceneUs > out.wireFreeUs) ? sceneUs : out.wireFreeUs;
+    uint8_t rec[OGOA_CAPTURE_RECORD_MAX];
+    while (len > 0u) {
+        size_t chunk = (len > OGOA_CAPTURE_CHUNK_MAX) ? OGOA_CAPTURE_CHUNK_MAX : len;
+        size_t n = ogoa_capture_record(&out.writer, OGOA_CAPTURE_RX, (uint32_t)t, data, chunk, rec);
+        if (fwrite(rec, 1, n, out.capture) != n) return false;
+        t += (uint64_t)chunk * out.usPerByte10 / 10u;
+        data += chunk;
+        len -= chunk;
+    }
+    out.wireFreeUs = t;
+    return true;
+}
+
+// ================= GENERATOR =================
+
+struct Config {
+    double rateHz = 5.0;
+    int delta = 2;
+    int sensors = 1;
+    double seconds = 10.0;
+    double loopS = 20.0;
+    double statusHz = 1.0;
+    float dropout = 0.01f;
+    float corrupt = 0.0f;
+    float garbage = 0.0f;
+    unsigned long baud = 115200;
+    uint64_t seed = 1;
+};
+
+struct Totals {
+    uint64_t sweeps, frames, points, corrupted, garbageBytes;
+    double castUs;
+};
+
+class Generator {
+public:
+    Generator(const Config& _cfg, Output& _out) : cfg(_cfg), out(_out), noise(_cfg.seed), seq(0) {
+        memset(smoothed, 0, sizeof(smoothed));
+        memset(scanSeq, 0, sizeof(scanSeq));
+        memset(&totals, 0, sizeof(totals));
+    }
+
+    bool frame(uint8_t type, const uint8_t* payload, uint8_t len, uint64_t sceneUs) {
+        uint8_t bytes[OGOA_FRAME_MAX_BYTES + 16u];
+        size_t pre = 0;
+
+        if (cfg.garbage > 0.0f && noise.uniform() < cfg.garbage) {
+            pre = 1u + noise.next() % 16u;
+            for (size_t i = 0; i < pre; i++) bytes[i] = (uint8_t)noise.next();
+            totals.garbageBytes += pre;
+        }
+
+        size_t n = ogoa_build_frame_bytes(seq++, type, payload, len, bytes + pre);
+        if (n == 0u) return false;
+        if (cfg.corrupt > 0.0f && noise.uniform() < cfg.corrupt) {
+            bytes[pre + noise.next() % n] ^= (uint8_t)(1u << (noise.next() % 8u));
+            totals.corrupted++;
+        }
+        totals.frames++;
+        return emit(out, bytes, pre + n, sceneUs);
+    }
+
+    // One full sweep per sensor. The rear sensor sees the same hallway
+    // turned round by 180 degrees.
+    bool sweep(double sceneS) {
+        uint64_t sceneUs = (uint64_t)(sceneS * 1e6);
+        Pose pose = poseAt(sceneS, cfg.loopS);
+
+        for (int sensor = 0; sensor < cfg.sensors; sensor++) {
+            auto t0 = std::chrono::steady_clock::now();
+            const float* hits = caster.cast(pose);
+            totals.castUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+            senseSweep(hits, smoothed[sensor], cfg.dropout, noise);
+            pose.headingDeg += 180.0f;
+
+            bool ok = (cfg.sensors == 1) ? sendLegacy(smoothed[sensor], sceneUs)
+                                         : sendScan((uint8_t)sensor, smoothed[sensor], sceneUs);
+            if (!ok) return false;
+        }
+        totals.sweeps++;
+        return true;
+    }
+
+    // LIDAR_SEND: for each phase of the angular step, chunks of up to
+    // GEN_POINTS_PER_FRAME samples whose start angle fits the uint8 field.
+    bool sendLegacy(const uint16_t* dist, uint64_t sceneUs) {
+        for (int phase = 0; phase < cfg.delta; phase++) {
+            for (int start = phase; start < GEN_BINS; start += GEN_POINTS_PER_FRAME * cfg.delta) {
+                uint8_t payload[2u + 2u * GEN_POINTS_PER_FRAME];
+                payload[0] = (uint8_t)start;
+                payload[1] = (uint8_t)cfg.delta;
+                uint8_t len = packPoints(dist, start, payload, 2u);
+                if (!frame(OGOA_TYPE_LIDAR_SEND, payload, len, sceneUs)) return false;
+            }
+        }
+        return true;
+    }
+
+    // LIDAR_SCAN: same chunking, tagged with sensor and scan sequence, the
+    // final chunk flagged so the display can publish without waiting.
+    bool sendScan(uint8_t sensor, const uint16_t* dist, uint64_t sceneUs) {
+        uint8_t seqNo = scanSeq[sensor]++;
+        for (int phase = 0; phase < cfg.delta; phase++) {
+            for (int start = phase; start < GEN_BINS; start += GEN_POINTS_PER_FRAME * cfg.delta) {
+                uint8_t payload[GEN_SCAN_HEADER_BYTES + 2u * GEN_POINTS_PER_FRAME];
+                bool last = phase == cfg.delta - 1 && start + GEN_POINTS_PER_FRAME * cfg.delta >= GEN_BINS;
+                payload[0] = sensor;
+                payload[1] = seqNo;
+                payload[2] = (uint8_t)(start & 0xFF);
+                payload[3] = (uint8_t)(start >> 8);
+                payload[4] = (uint8_t)cfg.delta;
+                payload[5] = last ? GEN_SCAN_FLAG_LAST : 0u;
+                uint8_t len = packPoints(dist, start, payload, GEN_SCAN_HEADER_BYTES);
+                if (!frame(OGOA_TYPE_LIDAR_SCAN, payload, len, sceneUs)) return false;
+            }
+        }
+        return true;
+    }
+
+    uint8_t packPoints(const uint16_t* dist, int start, uint8_t* payload, uint8_t len) {
+        for (int a = start, k = 0; a < GEN_BINS && k < GEN_POINTS_PER_FRAME; a += cfg.delta, k++) {
+            payload[len++] = (uint8_t)(dist[a] & 0xFFu);
+            payload[len++] = (uint8_t)(dist[a] >> 8);
+            totals.points++;
+        }
+        return len;
+    }
+
+    bool status(double sceneS) {
+        const uint8_t payload[3] = { 1u, 42u, 84u };
+        return frame(OGOA_TYPE_STATUS_RESPONSE, payload, sizeof(payload), (uint64_t)(sceneS * 1e6));
+    }
+
+    Totals totals;
+
+private:
+    const Config& cfg;
+    Output& out;
+    RayCaster caster;
+    Noise noise;
+    uint8_t seq;
+    uint8_t scanSeq[GEN_SENSORS_MAX];
+    uint16_t smoothed[GEN_SENSORS_MAX][GEN_BINS];
+};
+
+// ================= MAIN =================
+
+static void usage() {
+    fprintf(stderr, "usage: ogoa_gen [--rate HZ] [--delta DEG] [--sensors N] [--seconds S] [--loop S]\n"
+                    "                [--status-hz HZ] [--dropout P] [--corrupt P] [--garbage P] [--baud N] [--seed N]\n"
+                    "                --pty | --pipe PATH|- | --capture PATH\n");
+}
+
+int main(int argc, char** argv) {
+    Config cfg;
+    OutputKind kind = OUT_NONE;
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        bool used = true;
+
+        if (strcmp(a, "--pty") == 0) {
+            kind = OUT_PTY;
+            used = false;
+        } else if (v == nullptr) {
+            usage();
+            return 2;
+        } else if (strcmp(a, "--pipe") == 0) {
+            kind = OUT_PIPE;
+            path = v;
+        } else if (strcmp(a, "--capture") == 0) {
+            kind = OUT_CAPTURE;
+            path = v;
+        } else if (strcmp(a, "--rate") == 0) {
+            cfg.rateHz = atof(v);
+        } else if (strcmp(a, "--delta") == 0) {
+            cfg.delta = atoi(v);
+        } else if (strcmp(a, "--sensors") == 0) {
+            cfg.sensors = atoi(v);
+        } else if (strcmp(a, "--seconds") == 0) {
+            cfg.seconds = atof(v);
+        } else if (strcmp(a, "--loop") == 0) {
+            cfg.loopS = atof(v);
+        } else if (strcmp(a, "--status-hz") == 0) {
+            cfg.statusHz = atof(v);
+        } else if (strcmp(a, "--dropout") == 0) {
+            cfg.dropout = (float)atof(v);
+        } else if (strcmp(a, "--corrupt") == 0) {
+            cfg.corrupt = (float)atof(v);
+        } else if (strcmp(a, "--garbage") == 0) {
+            cfg.garbage = (float)atof(v);
+        } else if (strcmp(a, "--baud") == 0) {
+            cfg.baud = strtoul(v, nullptr, 10);
+        } else if (strcmp(a, "--seed") == 0) {
+            cfg.seed = strtoull(v, nullptr, 10);
+        } else {
+            usage();
+            return 2;
+        }
+        if (used) i++;
+    }
+
+    if (kind == OUT_NONE || cfg.delta < 1 || cfg.delta > 6 || cfg.sensors < 1 ||
+        cfg.sensors > GEN_SENSORS_MAX || cfg.rateHz < 0.0) {
+        usage();
+        return 2;
+    }
+
+    Output out;
+    if (!openOutput(out, kind, path, cfg.baud)) {
+        fprintf(stderr, "ogoa_gen: cannot open output: %s\n", strerror(errno));
+        return 1;
+    }
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    Generator gen(cfg, out);
+    bool realtime = kind != OUT_CAPTURE && cfg.rateHz > 0.0;
+    // Flat-out captures still need a scene clock: 100 sweeps per scene second.
+    double sweepStep = (cfg.rateHz > 0.0) ? 1.0 / cfg.rateHz : 0.01;
+    double statusStep = (cfg.statusHz > 0.0) ? 1.0 / cfg.statusHz : 0.0;
+    double nextStatus = 0.0;
+    auto wallStart = std::chrono::steady_clock::now();
+    bool ok = true;
+
+    for (double t = 0.0; t < cfg.seconds && ok && !stopRequested; t += sweepStep) {
+        if (realtime) std::this_thread::sleep_until(wallStart + std::chrono::duration<double>(t));
+        if (statusStep > 0.0 && t >= nextStatus) {
+            ok = gen.status(t);
+            nextStatus += statusStep;
+        }
+        ok = ok && gen.sweep(t);
+    }
+
+    double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    if (out.capture != nullptr) fclose(out.capture);
+    if (out.fd > STDERR_FILENO) close(out.fd);
+
+    const Totals& t = gen.totals;
+    fprintf(stderr,
+            "ogoa_gen: %llu sweeps, %llu frames, %llu points, %llu bytes in %.3f s (%.2f MB/s, %.0f frames/s)\n"
+            "          ray cast %.2f us/sweep, %llu frames corrupted, %llu garbage bytes, %llu bytes read back\n",
+            (unsigned long long)t.sweeps, (unsigned long long)t.frames, (unsigned long long)t.points,
+            (unsigned long long)out.bytes, wallS, wallS > 0 ? out.bytes / wallS / 1e6 : 0.0,
+            wallS > 0 ? t.frames / wallS : 0.0, t.sweeps ? t.castUs / t.sweeps : 0.0,
+            (unsigned long long)t.corrupted, (unsigned long long)t.garbageBytes,
+            (unsigned long long)out.readBack);
+    if (!ok) {
+        fprintf(stderr, "ogoa_gen: output closed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,256 @@
+// Host benchmark of ogoa::Link (lib/ogoa/ogoa_link.h) against the C context
+// of ogoa.c, built by the native_ogoa_link_bench env in platformio.ini.
+//
+// Both ends get the same work and must produce the same bytes and frames:
+//
+//   receive  a stream of LiDAR Scan frames, each checked, ACKed through the
+//            transport and handed to a frame handler;
+//   send     a status response out, and the peer's ACK for it back in;
+//   stats    a Stats Request in, which each end answers with its counters.
+//
+// The C context reaches its transport and handler through ogoa_ops_t
+// function pointers and takes one byte per call; the template inlines both
+// and takes the buffer. The transport takes everything and hashes it, and
+// keeps the last frame written for the stats answer.
+//
+//   ogoa_link_bench [--frames N] [--points N]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "ogoa.h"
+#include "ogoa_link.h"
+#include "ogoa_msg.h"
+
+#define BENCH_FRAMES 2000000u
+#define BENCH_STREAM_FRAMES 1024u
+#define BENCH_POINTS 60u
+
+// FNV-1a over everything written, and over what the handlers saw.
+struct Hash {
+    uint32_t h = 2166136261u;
+    void add(const uint8_t* p, size_t len) {
+        for (size_t i = 0; i < len; i++) h = (h ^ p[i]) * 16777619u;
+    }
+    void add(uint32_t v) { h = (h ^ v) * 16777619u; }
+};
+
+// The last whole frame written, while capturing is set; the transport
+// writes whole frames back to back, so each length byte says where the
+// next one starts.
+static bool capturing = false;
+
+struct LastFrame {
+    std::vector<uint8_t> bytes;
+    void add(const uint8_t* p, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            if (whole()) bytes.clear();
+            bytes.push_back(p[i]);
+        }
+    }
+    bool whole() const {
+        return bytes.size() > OGOA_HEADER_BYTES && bytes.size() == OGOA_HEADER_BYTES + bytes[3] + OGOA_CHECKSUM_BYTES;
+    }
+};
+
+static uint32_t clockMs = 0u;
+
+// ===== C CONTEXT =====
+
+struct CSide {
+    ogoa_ctx_t ctx;
+    Hash tx;
+    Hash rx;
+    LastFrame last;
+    uint32_t errors;
+};
+
+static CSide cSide;
+
+static int cTx(void*, const uint8_t* data, size_t len) {
+    cSide.tx.add(data, len);
+    if (capturing) cSide.last.add(data, len);
+    return (int)len;
+}
+
+static void cOnFrame(void*, const ogoa_frame_t* frame) {
+    cSide.rx.add(frame->seq);
+    cSide.rx.add(frame->type);
+    cSide.rx.add(frame->payload, frame->len);
+}
+
+static void cOnError(void*, ogoa_err_t) {
+    cSide.errors++;
+}
+
+// ===== TEMPLATE =====
+
+struct HashTx {
+    Hash hash;
+    LastFrame last;
+    int write(const uint8_t* data, size_t len) {
+        hash.add(data, len);
+        if (capturing) last.add(data, len);
+        return (int)len;
+    }
+};
+
+struct BenchClock {
+    uint32_t nowMs() { return clockMs; }
+};
+
+struct HashRx {
+    Hash hash;
+    uint32_t errors = 0;
+    void onFrame(const ogoa::FrameView& frame) {
+        hash.add(frame.seq);
+        hash.add(frame.type);
+        hash.add(frame.payload.data(), frame.payload.size());
+    }
+    void onError(ogoa_err_t) { errors++; }
+};
+
+typedef ogoa::Link<HashTx, BenchClock> BenchLink;
+
+static void usage() {
+    fprintf(stderr, "usage: ogoa_link_bench [--frames N] [--points N]\n");
+}
+
+static double nsSince(std::chrono::steady_clock::time_point t0, uint32_t frames) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / frames;
+}
+
+int main(int argc, char** argv) {
+    uint32_t frames = BENCH_FRAMES;
+    uint32_t points = BENCH_POINTS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            points = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (frames == 0u || points == 0u || 6u + 2u * points > OGOA_MAX_PAYLOAD) {
+        usage();
+        return 2;
+    }
+
+    // Peer traffic: LiDAR Scan chunks with rolling seq numbers, so none is
+    // dropped as a repeat.
+    std::vector<uint8_t> stream;
+    std::vector<size_t> frameEnds;
+    uint32_t rng = 1u;
+    for (uint32_t i = 0; i < BENCH_STREAM_FRAMES; i++) {
+        uint8_t payload[OGOA_MAX_PAYLOAD];
+        uint8_t len = (uint8_t)(6u + 2u * points);
+        for (uint8_t j = 0; j < len; j++) {
+            rng = rng * 1664525u + 1013904223u;
+            payload[j] = (uint8_t)(rng >> 24);
+        }
+        uint8_t frame[OGOA_FRAME_MAX_BYTES];
+        size_t n = ogoa_build_frame_bytes((uint8_t)i, OGOA_TYPE_LIDAR_SCAN, payload, len, frame);
+        stream.insert(stream.end(), frame, frame + n);
+        frameEnds.push_back(stream.size());
+    }
+
+    static HashTx tTx;
+    static BenchClock tClock;
+    static HashRx tRx;
+    static BenchLink link(tTx, tClock);
+    const ogoa_ops_t ops = { cTx, cOnFrame, cOnError };
+    ogoa_init(&cSide.ctx, &ops, nullptr);
+
+    // Receive: whole stream passes, frame by frame.
+    uint32_t passes = frames / BENCH_STREAM_FRAMES + 1u;
+    uint32_t received = passes * BENCH_STREAM_FRAMES;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < passes; pass++) {
+        for (size_t i = 0; i < stream.size(); i++) ogoa_process_byte(&cSide.ctx, stream[i], clockMs);
+        clockMs++;
+    }
+    double cRxNs = nsSince(t0, received);
+
+    clockMs = 0u;
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t pass = 0; pass < passes; pass++) {
+        size_t start = 0;
+        for (size_t end : frameEnds) {
+            link.receive(&stream[start], end - start, tRx);
+            start = end;
+        }
+        clockMs++;
+    }
+    double tRxNs = nsSince(t0, received);
+
+    // Send: status response out, ACK back.
+    const ogoa::StatusResponse status = { 0u, 128u, 128u };
+    uint8_t statusPayload[OGOA_MAX_PAYLOAD];
+    uint8_t statusLen = ogoa::encode(status, statusPayload);
+    uint32_t sendFailures = 0u;
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; i++) {
+        if (ogoa_send(&cSide.ctx, OGOA_TYPE_STATUS_RESPONSE, statusPayload, statusLen, clockMs) != OGOA_OK) {
+            sendFailures++;
+        }
+        uint8_t ack[OGOA_HEADER_BYTES + OGOA_CHECKSUM_BYTES];
+        size_t n = ogoa_build_frame_bytes(cSide.ctx.tx_pending_seq, OGOA_TYPE_ACK, nullptr, 0u, ack);
+        for (size_t j = 0; j < n; j++) ogoa_process_byte(&cSide.ctx, ack[j], clockMs);
+        ogoa_tick(&cSide.ctx, clockMs);
+    }
+    double cTxNs = nsSince(t0, frames);
+
+    uint8_t seq = 0u;   // the template has sent nothing yet
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; i++) {
+        if (link.send(status) != OGOA_OK) sendFailures++;
+        uint8_t ack[OGOA_HEADER_BYTES + OGOA_CHECKSUM_BYTES];
+        size_t n = ogoa_build_frame_bytes(seq++, OGOA_TYPE_ACK, nullptr, 0u, ack);
+        link.receive(ack, n, tRx);
+        link.tick(tRx);
+    }
+    double tTxNs = nsSince(t0, frames);
+
+    // Stats: the same request to both, then the ACK for each answer.
+    uint8_t request[OGOA_HEADER_BYTES + OGOA_CHECKSUM_BYTES];
+    size_t requestLen = ogoa_build_frame_bytes(0u, OGOA_TYPE_STATS_REQUEST, nullptr, 0u, request);
+    capturing = true;
+    for (size_t j = 0; j < requestLen; j++) ogoa_process_byte(&cSide.ctx, request[j], clockMs);
+    link.receive(request, requestLen, tRx);
+    capturing = false;
+    ogoa::StatsResponse cStats = {}, tStats = {};
+    bool answered = cSide.last.whole() && tTx.last.whole() && cSide.last.bytes[2] == OGOA_TYPE_STATS_RESPONSE &&
+                    tTx.last.bytes[2] == OGOA_TYPE_STATS_RESPONSE &&
+                    ogoa::decode(&cSide.last.bytes[OGOA_HEADER_BYTES], cSide.last.bytes[3], &cStats) &&
+                    ogoa::decode(&tTx.last.bytes[OGOA_HEADER_BYTES], tTx.last.bytes[3], &tStats);
+    uint8_t ack[OGOA_HEADER_BYTES + OGOA_CHECKSUM_BYTES];
+    size_t ackLen = ogoa_build_frame_bytes(cSide.ctx.tx_pending_seq, OGOA_TYPE_ACK, nullptr, 0u, ack);
+    for (size_t j = 0; j < ackLen; j++) ogoa_process_byte(&cSide.ctx, ack[j], clockMs);
+    ackLen = ogoa_build_frame_bytes(seq, OGOA_TYPE_ACK, nullptr, 0u, ack);
+    link.receive(ack, ackLen, tRx);
+    bool sameStats = answered && cSide.last.bytes == tTx.last.bytes &&
+                     memcmp(&cSide.ctx.stats, &link.stats, sizeof(ogoa_stats_t)) == 0;
+
+    bool same = cSide.tx.h == tTx.hash.h && cSide.rx.h == tRx.hash.h && cSide.errors == tRx.errors &&
+                sendFailures == 0u && link.awaitingAck() == 0u && cSide.ctx.tx_waiting_ack == 0u && sameStats;
+
+    printf("%u frames, %u points per LiDAR chunk\n", received, points);
+    printf("receive    C %7.2f ns/frame   template %7.2f ns/frame  (x%.2f)\n", cRxNs, tRxNs,
+           tRxNs > 0 ? cRxNs / tRxNs : 0.0);
+    printf("send       C %7.2f ns/frame   template %7.2f ns/frame  (x%.2f)\n", cTxNs, tTxNs,
+           tTxNs > 0 ? cTxNs / tTxNs : 0.0);
+    printf("size       C %u B   template %u B per link\n", (unsigned)sizeof(ogoa_ctx_t), (unsigned)sizeof(BenchLink));
+    printf("stats      C %u/%u frames in/out, %u B in   template %u/%u, %u B  %s\n", cStats.rxFrames,
+           cStats.txFrames, cStats.rxBytes, tStats.rxFrames, tStats.txFrames, tStats.rxBytes,
+           sameStats ? "same" : "DIFFERENT");
+    printf("bytes out  %08x %08x, frames in %08x %08x, %u send failures  %s\n", cSide.tx.h, tTx.hash.h,
+           cSide.rx.h, tRx.hash.h, sendFailures, same ? "ok" : "MISMATCH");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+// Host benchmark of the typed OGOA payloads (lib/ogoa/ogoa_msg.h), built by
+// the native_ogoa_msg_bench env in platformio.ini.
+//
+// Decodes the same mix of frames two ways: the hand-written switch and byte
+// reads the link used before, and ogoa::Dispatcher's table with the decode
+// generated from each message's layout. Each is reached the way ogoa.c
+// reaches the link, through the on_frame pointer. Both feed the fields a
+// chunk handler would use into one checksum, which has to match. The frames
+// are split into rounds that alternate which handler goes first; each is
+// reported by its best round (the least disturbed) and its median. The mix is a
+// running link: mostly LiDAR Scan chunks from both sensors, some LiDAR Send,
+// status responses, ACKs with a payload, and now and then an unknown type or
+// a frame too short for its type.
+//
+//   ogoa_msg_bench [--frames N] [--points N] [--rounds N]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "ogoa.h"
+#include "ogoa_msg.h"
+
+#define BENCH_FRAMES 20000000u
+#define BENCH_MIX 4096u
+#define BENCH_POINTS 60u
+#define BENCH_ROUNDS 21u
+
+static uint32_t randomState = 1u;
+
+static uint32_t nextRandom() {
+    randomState = randomState * 1664525u + 1013904223u;
+    return randomState >> 8;
+}
+
+static ogoa_frame_t makeFrame(uint32_t i, uint8_t points) {
+    ogoa_frame_t f = {};
+    f.seq = (uint8_t)i;
+    uint32_t k = i % 32u;
+    if (k == 0u) {
+        f.type = OGOA_TYPE_STATUS_RESPONSE;
+        f.len = 3u;
+    } else if (k == 1u) {
+        f.type = OGOA_TYPE_ACK;
+        f.len = 1u;
+    } else if (k == 2u) {
+        f.type = (i % 64u == 2u) ? 0x99u : OGOA_TYPE_STATUS_RESPONSE;
+        f.len = 2u;                                    // unknown, or too short
+    } else if (k < 8u) {
+        f.type = OGOA_TYPE_LIDAR_SEND;
+        f.len = (uint8_t)(2u + 2u * points);
+    } else {
+        f.type = OGOA_TYPE_LIDAR_SCAN;
+        f.len = (uint8_t)(6u + 2u * points);
+    }
+    for (uint8_t j = 0; j < f.len; j++) f.payload[j] = (uint8_t)nextRandom();
+    if (f.type == OGOA_TYPE_LIDAR_SCAN) {
+        f.payload[0] = (uint8_t)(i & 1u);
+        f.payload[3] &= 0x01u;
+    }
+    return f;
+}
+
+// What the link's handlers pass on, folded into one number.
+static uint32_t sink;
+
+static void fold(uint32_t sensor, uint32_t seq, uint32_t start, uint32_t delta, uint32_t last, uint32_t count,
+                 uint32_t first) {
+    sink = sink * 31u + (sensor ^ (seq << 4) ^ (start << 8) ^ (delta << 20) ^ (last << 28));
+    sink = sink * 31u + (count ^ (first << 8));
+}
+
+// ===== HAND-WRITTEN =====
+// The switch and byte reads from src/link.cpp before ogoa_msg.h.
+
+static void handOnFrame(void*, const ogoa_frame_t* frame) {
+    switch (frame->type) {
+        case OGOA_TYPE_ACK:
+            sink += frame->seq;
+            break;
+
+        case OGOA_TYPE_STATUS_REQUEST:
+            sink += 1u;
+            break;
+
+        case OGOA_TYPE_STATUS_RESPONSE:
+            if (frame->len >= 3u) {
+                fold(frame->payload[0], frame->payload[1], frame->payload[2], 0u, 0u, 0u, 0u);
+            } else {
+                sink += 0x5A5Au + frame->type;
+            }
+            break;
+
+        case OGOA_TYPE_LIDAR_SEND:
+            if (frame->len < 4u) {
+                sink += 0x5A5Au + frame->type;
+                break;
+            }
+            fold(0u, 0u, frame->payload[0], frame->payload[1], 0u, (uint8_t)((frame->len - 2u) / 2u),
+                 (uint32_t)(frame->payload[2] | (frame->payload[3] << 8)));
+            break;
+
+        case OGOA_TYPE_LIDAR_SCAN: {
+            if (frame->len < 6u + 2u) {
+                sink += 0x5A5Au + frame->type;
+                break;
+            }
+            const uint8_t* d = &frame->payload[6];
+            fold(frame->payload[0], frame->payload[1], (uint16_t)(frame->payload[2] | (frame->payload[3] << 8)),
+                 frame->payload[4], (frame->payload[5] & OGOA_SCAN_FLAG_LAST) != 0u,
+                 (uint8_t)((frame->len - 6u) / 2u), (uint32_t)(d[0] | (d[1] << 8)));
+            break;
+        }
+
+        default:
+            sink += 0xA5A5u + frame->type;
+            break;
+    }
+}
+
+// ===== TYPED =====
+
+static void onAck(const ogoa::Ack&, const ogoa_frame_t& frame) {
+    sink += frame.seq;
+}
+
+static void onStatusRequest(const ogoa::StatusRequest&, const ogoa_frame_t&) {
+    sink += 1u;
+}
+
+static void onStatusResponse(const ogoa::StatusResponse& msg, const ogoa_frame_t&) {
+    fold(msg.mode, msg.x, msg.y, 0u, 0u, 0u, 0u);
+}
+
+static void onLidarSend(const ogoa::LidarSend& msg, const ogoa_frame_t&) {
+    fold(0u, 0u, msg.startTheta, msg.deltaTheta, 0u, msg.distances.count, msg.distances[0]);
+}
+
+static void onLidarScan(const ogoa::LidarScan& msg, const ogoa_frame_t&) {
+    fold(msg.sensor, msg.scanSeq, msg.startTheta, msg.deltaTheta, (msg.flags & OGOA_SCAN_FLAG_LAST) != 0u,
+         msg.distances.count, msg.distances[0]);
+}
+
+static void onUnknown(const ogoa_frame_t& frame) {
+    sink += 0xA5A5u + frame.type;
+}
+
+static void onMalformed(const ogoa_frame_t& frame) {
+    sink += 0x5A5Au + frame.type;
+}
+
+typedef ogoa::Dispatcher<onUnknown, onMalformed,
+                         ogoa::On<ogoa::Ack, onAck>,
+                         ogoa::On<ogoa::StatusRequest, onStatusRequest>,
+                         ogoa::On<ogoa::StatusResponse, onStatusResponse>,
+                         ogoa::On<ogoa::LidarSend, onLidarSend>,
+                         ogoa::On<ogoa::LidarScan, onLidarScan>> BenchDispatch;
+
+static void typedOnFrame(void*, const ogoa_frame_t* frame) {
+    BenchDispatch::dispatch(*frame);
+}
+
+// ns/frame over one round, and its checksum.
+static double timeRound(ogoa_rx_fn onFrame, const std::vector<ogoa_frame_t>& mix, uint32_t frames, uint32_t* sum) {
+    sink = 0u;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; i++) onFrame(nullptr, &mix[i % BENCH_MIX]);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / frames;
+    *sum = sink;
+    return ns;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: ogoa_msg_bench [--frames N] [--points N] [--rounds N]\n");
+}
+
+int main(int argc, char** argv) {
+    uint32_t frames = BENCH_FRAMES;
+    uint32_t points = BENCH_POINTS;
+    uint32_t rounds = BENCH_ROUNDS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            points = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--rounds") == 0 && i + 1 < argc) {
+            rounds = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (frames == 0u || points == 0u || rounds == 0u || 6u + 2u * points > OGOA_MAX_PAYLOAD) {
+        usage();
+        return 2;
+    }
+
+    std::vector<ogoa_frame_t> mix;
+    for (uint32_t i = 0; i < BENCH_MIX; i++) mix.push_back(makeFrame(i, (uint8_t)points));
+
+    // Through a volatile pointer, so neither path is inlined into the loop.
+    ogoa_rx_fn volatile handFn = handOnFrame;
+    ogoa_rx_fn volatile typedFn = typedOnFrame;
+    std::vector<double> handNs;
+    std::vector<double> typedNs;
+    uint32_t handSum = 0u;
+    uint32_t typedSum = 0u;
+    uint32_t perRound = frames / rounds + 1u;
+    for (uint32_t round = 0; round < rounds; round++) {
+        if (round % 2u == 0u) {
+            handNs.push_back(timeRound(handFn, mix, perRound, &handSum));
+            typedNs.push_back(timeRound(typedFn, mix, perRound, &typedSum));
+        } else {
+            typedNs.push_back(timeRound(typedFn, mix, perRound, &typedSum));
+            handNs.push_back(timeRound(handFn, mix, perRound, &handSum));
+        }
+    }
+    std::sort(handNs.begin(), handNs.end());
+    std::sort(typedNs.begin(), typedNs.end());
+    double handMin = handNs.front();
+    double typedMin = typedNs.front();
+    double handMedian = handNs[handNs.size() / 2u];
+    double typedMedian = typedNs[typedNs.size() / 2u];
+
+    printf("%u frames in %u alternating rounds, %u points per LiDAR chunk\n", frames, rounds, points);
+    printf("switch     %8.2f ns/frame best, %8.2f median\n", handMin, handMedian);
+    printf("table      %8.2f ns/frame best, %8.2f median  (x%.2f best, x%.2f median)\n", typedMin, typedMedian,
+           typedMin > 0 ? handMin / typedMin : 0.0, typedMedian > 0 ? handMedian / typedMedian : 0.0);
+    printf("checksum   %08x %08x %s\n", handSum, typedSum, handSum == typedSum ? "ok" : "MISMATCH");
+    return handSum == typedSum ? 0 : 1;
+}
@@ -0,0 +1,478 @@
+// Host check of OGOA requests (ogoa_send_request, lib/ogoa/ogoa_await.h),
+// built by the native_ogoa_req_bench env in platformio.ini.
+//
+// Two ogoa.c ends on a simulated line that delays every write and loses some
+// of them whole. The SYSMCU end issues requests one after another: mostly
+// LiDAR chunks, which complete on their ACK, and every fourth a status
+// request, which completes on the display's status response. The display
+// answers with its last received seq in the response, so the SYSMCU can tell
+// a response to this request from a late one to an earlier request.
+//
+// The same run is made twice from the same seed, once with done callbacks
+// and once with a coroutine awaiting ogoa::Request. Neither polls the
+// context: the callback issues the next request from inside done, the
+// coroutine resumes there, and only a refused send waits for the next tick.
+// Each request must complete exactly once, no request may be left attached
+// to the context, a clean line must time nothing out, and both runs must end
+// the same. Last, the SYSMCU reads the display's counters with a Stats
+// Request, which ogoa.c answers by itself; the C and the typed decode of
+// the answer must agree, and no counter may be ahead of the display's own.
+// Then, on a clean line, a status request the display ignores must time out
+// OGOA_RESPONSE_TIMEOUT_MS after it was sent, although the SYSMCU keeps a
+// LiDAR chunk awaiting its ACK at every tick meanwhile.
+// Exits 1 if not.
+//
+//   ogoa_req_bench [--requests N] [--loss P] [--latency MS] [--seed N]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <vector>
+
+#include "ogoa.h"
+#include "ogoa_await.h"
+#include "ogoa_msg.h"
+
+#define BENCH_REQUESTS 20000u
+#define BENCH_POINTS 30u
+#define BENCH_STATUS_EVERY 4u
+#define BENCH_DRAIN_LIMIT_MS 10000u
+
+static uint32_t nowMs = 0u;
+static uint32_t randomState = 1u;
+
+static uint32_t nextRandom() {
+    randomState = randomState * 1664525u + 1013904223u;
+    return randomState >> 8;
+}
+
+// ===== LINE =====
+
+struct Chunk {
+    uint32_t dueMs;
+    std::vector<uint8_t> bytes;
+};
+
+struct Line {
+    std::deque<Chunk> inFlight;
+    ogoa_ctx_t* to;
+    uint64_t writes;
+    uint64_t lost;
+};
+
+static double lossRate = 0.02;
+static uint32_t latencyMs = 3u;
+
+static int lineTx(void* user, const uint8_t* data, size_t len) {
+    Line* line = static_cast<Line*>(user);
+    line->writes++;
+    if ((double)(nextRandom() & 0xFFFFu) / 65536.0 < lossRate) {
+        line->lost++;
+    } else {
+        line->inFlight.push_back(Chunk{ nowMs + latencyMs, std::vector<uint8_t>(data, data + len) });
+    }
+    return (int)len;
+}
+
+static void lineDeliver(Line* line) {
+    while (!line->inFlight.empty() && line->inFlight.front().dueMs <= nowMs) {
+        Chunk chunk = std::move(line->inFlight.front());
+        line->inFlight.pop_front();
+        for (uint8_t b : chunk.bytes) ogoa_process_byte(line->to, b, nowMs);
+    }
+}
+
+// ===== DISPLAY =====
+
+static ogoa_ctx_t dispCtx;
+static ogoa_ctx_t mcuCtx;
+static Line toMcu;
+static Line toDisp;
+static uint8_t mcuDirectSeq;
+static bool dispAnswersStatus = true;
+
+// A status request is answered at once, naming its seq; a refused answer
+// leaves the request to time out, as on the device.
+static void dispOnFrame(void*, const ogoa_frame_t* frame) {
+    if (frame->type == OGOA_TYPE_STATUS_REQUEST && dispAnswersStatus) {
+        const ogoa::StatusResponse status = { 0u, frame->seq, 0u };
+        (void)ogoa::send(&dispCtx, status, nowMs);
+    }
+}
+
+// The SYSMCU answers the display's status loop the same way, and straight
+// onto the line when its own context is busy: ogoa.c sends nothing while in
+// its own status loop, so two ends in the loop would never leave it.
+static void mcuOnFrame(void*, const ogoa_frame_t* frame) {
+    if (frame->type == OGOA_TYPE_STATUS_REQUEST) {
+        const ogoa::StatusResponse status = { 0u, frame->seq, 0u };
+        if (ogoa::send(&mcuCtx, status, nowMs) != OGOA_OK) {
+            uint8_t payload[OGOA_MAX_PAYLOAD];
+            uint8_t bytes[OGOA_FRAME_MAX_BYTES];
+            size_t n = ogoa_build_frame_bytes(mcuDirectSeq++, OGOA_TYPE_STATUS_RESPONSE, payload,
+                                              ogoa::encode(status, payload), bytes);
+            lineTx(&toDisp, bytes, n);
+        }
+    }
+}
+
+// ===== OUTCOMES =====
+
+struct Tally {
+    uint32_t issued;
+    uint32_t refused;                 // sends that had to wait a tick
+    uint32_t done[OGOA_REQ_TIMEOUT + 1];
+    uint32_t stale;                   // response that answered an earlier request
+    uint32_t repeats;                 // completions after the first
+    uint64_t latencyMsSum;
+    uint32_t latencyMsMax;
+    uint32_t wakeups;                 // times the caller's code ran
+    std::vector<uint8_t> completions; // per request
+    std::vector<uint8_t> states;
+};
+
+static void tallyDone(Tally* t, uint32_t id, ogoa_req_state_t state, uint8_t seq, const ogoa_frame_t* response,
+                      uint32_t latency) {
+    if (t->completions[id]++ != 0u) {
+        t->repeats++;
+        return;
+    }
+    t->done[state]++;
+    t->states[id] = (uint8_t)state;
+    if (state == OGOA_REQ_RESPONDED && response->payload[1] != seq) t->stale++;
+    t->latencyMsSum += latency;
+    if (latency > t->latencyMsMax) t->latencyMsMax = latency;
+}
+
+static bool isStatusRequest(uint32_t id) {
+    return id % BENCH_STATUS_EVERY == BENCH_STATUS_EVERY - 1u;
+}
+
+static ogoa_err_t issue(uint32_t id, ogoa_request_t* req) {
+    if (isStatusRequest(id)) {
+        return ogoa::sendRequest(&mcuCtx, req, ogoa::StatusRequest{}, nowMs);
+    }
+    uint16_t distances[BENCH_POINTS];
+    for (uint16_t& d : distances) d = (uint16_t)(nextRandom() & 0x0FFFu);
+    const ogoa::LidarSend chunk = { 0u, 1u, { reinterpret_cast<const uint8_t*>(distances), BENCH_POINTS } };
+    return ogoa::sendRequest(&mcuCtx, req, chunk, nowMs);
+}
+
+// ===== CALLBACKS =====
+
+struct CallbackRun {
+    Tally* tally;
+    uint32_t total;
+    uint32_t next;
+    bool waiting;                     // a refused send, tried again next tick
+    ogoa_request_t req;
+    ogoa_frame_t response;
+};
+
+static void issueNext(CallbackRun* run) {
+    run->tally->wakeups++;
+    run->waiting = false;
+    if (run->next == run->total) return;
+    run->req.done = nullptr;
+    run->req.user_ctx = run;
+    run->req.response = &run->response;
+    run->req.done = [](void* user, ogoa_request_t* req) {
+        CallbackRun* r = static_cast<CallbackRun*>(user);
+        tallyDone(r->tally, r->next - 1u, req->state, req->seq, r->req.response, req->done_ms - req->sent_ms);
+        issueNext(r);
+    };
+    if (issue(run->next, &run->req) == OGOA_OK) {
+        run->tally->issued++;
+        run->next++;
+    } else {
+        run->tally->refused++;
+        run->waiting = true;
+    }
+}
+
+// ===== COROUTINE =====
+
+// Fire and forget: runs until its first co_await, frees itself at the end.
+struct Task {
+    struct promise_type {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { abort(); }
+    };
+};
+
+// Resumes the coroutine from the next tick.
+static std::coroutine_handle<> tickWaiter;
+
+struct NextTick {
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> h) { tickWaiter = h; }
+    void await_resume() const {}
+};
+
+static Task requestLoop(Tally* t, uint32_t total, bool* finished) {
+    ogoa_frame_t response = {};
+    for (uint32_t id = 0; id < total; id++) {
+        ogoa::Outcome r;
+        uint8_t seq;
+        uint32_t sentMs;
+        for (;;) {
+            t->wakeups++;
+            sentMs = nowMs;
+            seq = mcuCtx.next_seq;
+            if (isStatusRequest(id)) {
+                r = co_await ogoa::Request(&mcuCtx, ogoa::StatusRequest{}, nowMs, &response);
+            } else {
+                uint16_t distances[BENCH_POINTS];
+                for (uint16_t& d : distances) d = (uint16_t)(nextRandom() & 0x0FFFu);
+                const ogoa::LidarSend chunk = { 0u, 1u, { reinterpret_cast<const uint8_t*>(distances), BENCH_POINTS } };
+                r = co_await ogoa::Request(&mcuCtx, chunk, nowMs, &response);
+            }
+            if (r.error == OGOA_OK) break;
+            t->refused++;
+            co_await NextTick{};
+        }
+        t->issued++;
+        tallyDone(t, id, r.state, seq, &response, nowMs - sentMs);
+    }
+    t->wakeups++;
+    *finished = true;
+}
+
+// ===== DRIVER =====
+
+static void resetLink() {
+    const ogoa_ops_t dispOps = { lineTx, dispOnFrame, nullptr };
+    const ogoa_ops_t mcuOps = { lineTx, mcuOnFrame, nullptr };
+    toMcu = Line{};
+    toDisp = Line{};
+    toMcu.to = &mcuCtx;
+    toDisp.to = &dispCtx;
+    mcuDirectSeq = 0x80u;
+    ogoa_init(&dispCtx, &dispOps, &toMcu);
+    ogoa_init(&mcuCtx, &mcuOps, &toDisp);
+    nowMs = 0u;
+}
+
+// One simulated millisecond: the line, then both ends' timers.
+static void step() {
+    nowMs++;
+    lineDeliver(&toDisp);
+    lineDeliver(&toMcu);
+    ogoa_tick(&dispCtx, nowMs);
+    ogoa_tick(&mcuCtx, nowMs);
+}
+
+static bool settled() {
+    return toMcu.inFlight.empty() && toDisp.inFlight.empty() && mcuCtx.tx_request == nullptr &&
+           mcuCtx.rsp_request == nullptr;
+}
+
+struct RunResult {
+    double wallNs;
+    uint32_t simMs;
+    uint64_t lost;
+    uint64_t writes;
+};
+
+static RunResult runCallbacks(Tally* t, uint32_t total) {
+    resetLink();
+    static CallbackRun run;
+    run = CallbackRun{};
+    run.tally = t;
+    run.total = total;
+    auto t0 = std::chrono::steady_clock::now();
+    issueNext(&run);
+    uint32_t drainMs = 0u;
+    while (run.next < total || !settled()) {
+        step();
+        if (run.waiting) issueNext(&run);
+        if (run.next == total && ++drainMs > BENCH_DRAIN_LIMIT_MS) break;
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    return RunResult{ ns, nowMs, toMcu.lost + toDisp.lost, toMcu.writes + toDisp.writes };
+}
+
+static RunResult runCoroutine(Tally* t, uint32_t total) {
+    resetLink();
+    bool finished = false;
+    auto t0 = std::chrono::steady_clock::now();
+    requestLoop(t, total, &finished);
+    uint32_t drainMs = 0u;
+    while (!finished || !settled()) {
+        step();
+        if (tickWaiter) {
+            std::coroutine_handle<> h = tickWaiter;
+            tickWaiter = nullptr;
+            h.resume();
+        }
+        if (++drainMs > total * 1000u + BENCH_DRAIN_LIMIT_MS) break;
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    return RunResult{ ns, nowMs, toMcu.lost + toDisp.lost, toMcu.writes + toDisp.writes };
+}
+
+static void report(const char* name, const Tally& t, const RunResult& r) {
+    uint32_t completed = t.done[OGOA_REQ_ACKED] + t.done[OGOA_REQ_RESPONDED] + t.done[OGOA_REQ_TIMEOUT];
+    printf("%-9s  %u issued, %u ACKed, %u responded (%u stale), %u timed out, %u refused sends\n", name, t.issued,
+           t.done[OGOA_REQ_ACKED], t.done[OGOA_REQ_RESPONDED], t.stale, t.done[OGOA_REQ_TIMEOUT], t.refused);
+    printf("           latency mean %.1f ms, max %u ms; %.2f wakeups per request over %u ms of line time\n",
+           completed ? (double)t.latencyMsSum / completed : 0.0, t.latencyMsMax,
+           t.issued ? (double)t.wakeups / t.issued : 0.0, r.simMs);
+    printf("           %.0f ns host time per request\n", t.issued ? r.wallNs / t.issued : 0.0);
+}
+
+static bool exactlyOnce(const Tally& t, uint32_t total) {
+    if (t.issued != total || t.repeats != 0u) return false;
+    for (uint8_t c : t.completions) {
+        if (c != 1u) return false;
+    }
+    return true;
+}
+
+// Stats Request until answered, stepping the line; false if never.
+static bool readPeerStats(ogoa_stats_t* out) {
+    for (uint32_t tries = 0; tries < 100u; tries++) {
+        ogoa_request_t req = {};
+        ogoa_frame_t response = {};
+        req.response = &response;
+        if (ogoa::sendRequest(&mcuCtx, &req, ogoa::StatsRequest{}, nowMs) != OGOA_OK) {
+            step();
+            continue;
+        }
+        while (req.state == OGOA_REQ_PENDING) step();
+        if (req.state != OGOA_REQ_RESPONDED) continue;
+        ogoa::StatsResponse typed;
+        if (!ogoa_stats_decode(response.payload, response.len, out) || !ogoa::decode(response, &typed)) return false;
+        return typed.rxBytes == out->rx_bytes && typed.rxFrames == out->rx_frames &&
+               typed.duplicates == out->duplicates && typed.txFaults == out->tx_faults;
+    }
+    return false;
+}
+
+static bool notAhead(const ogoa_stats_t& reported, const ogoa_stats_t& actual) {
+    const uint32_t* r = reinterpret_cast<const uint32_t*>(&reported);
+    const uint32_t* a = reinterpret_cast<const uint32_t*>(&actual);
+    for (size_t i = 0; i < OGOA_STATS_FIELDS; i++) {
+        if (r[i] > a[i]) return false;
+    }
+    return true;
+}
+
+// ===== RESPONSE TIMEOUT UNDER TRAFFIC =====
+
+// Each chunk's done sends the next, from inside the ACK's delivery, so
+// every tick finds a chunk awaiting its ACK.
+struct Traffic {
+    ogoa_request_t req;
+    uint32_t sent;
+};
+
+static void sendTraffic(Traffic* t) {
+    t->req = ogoa_request_t{};
+    t->req.user_ctx = t;
+    t->req.done = [](void* user, ogoa_request_t*) { sendTraffic(static_cast<Traffic*>(user)); };
+    if (issue(0u, &t->req) == OGOA_OK) t->sent++;
+}
+
+// Milliseconds from sending the ignored status request to its timeout, or
+// 0 if it did not time out within a second of it.
+static uint32_t responseTimeoutUnderTraffic(uint32_t* chunks) {
+    double savedLoss = lossRate;
+    lossRate = 0.0;
+    dispAnswersStatus = false;
+    resetLink();
+
+    ogoa_request_t status = {};
+    uint32_t waited = 0u;
+    if (ogoa::sendRequest(&mcuCtx, &status, ogoa::StatusRequest{}, nowMs) == OGOA_OK) {
+        while (status.state == OGOA_REQ_PENDING && mcuCtx.tx_waiting_ack) step();
+        static Traffic traffic;
+        traffic = Traffic{};
+        sendTraffic(&traffic);
+        while (status.state == OGOA_REQ_PENDING && nowMs - status.sent_ms < 1000u) step();
+        if (status.state == OGOA_REQ_TIMEOUT) waited = status.done_ms - status.sent_ms;
+        ogoa_request_cancel(&mcuCtx, &status);
+        ogoa_request_cancel(&mcuCtx, &traffic.req);
+        *chunks = traffic.sent;
+    }
+
+    dispAnswersStatus = true;
+    lossRate = savedLoss;
+    return waited;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: ogoa_req_bench [--requests N] [--loss P] [--latency MS] [--seed N]\n");
+}
+
+int main(int argc, char** argv) {
+    uint32_t total = BENCH_REQUESTS;
+    uint32_t seed = 1u;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        if (strcmp(argv[i], "--requests") == 0) total = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--loss") == 0) lossRate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--latency") == 0) latencyMs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--seed") == 0) seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (total == 0u || lossRate < 0.0 || lossRate >= 1.0 || 2u * latencyMs >= OGOA_ACK_TIMEOUT_MS) {
+        usage();
+        return 2;
+    }
+
+    static Tally cb;
+    static Tally co;
+    cb.completions.assign(total, 0u);
+    cb.states.assign(total, 0u);
+    co.completions.assign(total, 0u);
+    co.states.assign(total, 0u);
+
+    randomState = seed;
+    RunResult cbRun = runCallbacks(&cb, total);
+    bool cbSettled = settled();
+    randomState = seed;
+    RunResult coRun = runCoroutine(&co, total);
+    bool coSettled = settled();
+    ogoa_stats_t peer = {};
+    bool statsRead = readPeerStats(&peer);
+    bool statsOk = statsRead && notAhead(peer, dispCtx.stats);
+    uint32_t trafficChunks = 0u;
+    uint32_t timeoutMs = responseTimeoutUnderTraffic(&trafficChunks);
+    bool timeoutOk = timeoutMs == OGOA_RESPONSE_TIMEOUT_MS;
+
+    bool clean = lossRate > 0.0 || (cb.done[OGOA_REQ_TIMEOUT] == 0u && co.done[OGOA_REQ_TIMEOUT] == 0u &&
+                                    cb.stale == 0u && co.stale == 0u);
+    bool same = cb.states == co.states && cbRun.simMs == coRun.simMs;
+    bool ok = exactlyOnce(cb, total) && exactlyOnce(co, total) && cbSettled && coSettled && clean && same && statsOk &&
+              timeoutOk;
+
+    printf("%u requests (1 in %u a status request), %.1f%% of writes lost, %u ms each way\n", total,
+           BENCH_STATUS_EVERY, lossRate * 100.0, latencyMs);
+    report("callback", cb, cbRun);
+    report("coroutine", co, coRun);
+    printf("line       %llu writes, %llu lost\n", (unsigned long long)cbRun.writes, (unsigned long long)cbRun.lost);
+    printf("display    %lu frames in (%lu duplicates, %lu bad checksums), %lu retransmits, %lu status loops%s\n",
+           (unsigned long)peer.rx_frames, (unsigned long)peer.duplicates, (unsigned long)peer.checksum_errors,
+           (unsigned long)peer.retransmits, (unsigned long)peer.status_loops,
+           statsOk ? ", by Stats Request" : ", Stats Request FAILED");
+    printf("unanswered status request timed out after %u ms (%u) under %u chunks  %s\n", timeoutMs,
+           OGOA_RESPONSE_TIMEOUT_MS, trafficChunks, timeoutOk ? "ok" : "LATE");
+    printf("completed once each: %s, %s; same outcomes: %s  %s\n", exactlyOnce(cb, total) ? "yes" : "NO",
+           exactlyOnce(co, total) ? "yes" : "NO", same ? "yes" : "NO", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,282 @@
+// Host check of the OGOA transmit ring (lib/ogoa) against a throttled
+// transport, built by the native_ogoa_tx_bench env in platformio.ini.
+//
+// The display side runs the real ogoa.c. Its tx op is a fake UART: a FIFO
+// that drains at the baud rate on a simulated clock, takes at most what has
+// room (often less, at random) and now and then nothing at all. A peer, also
+// ogoa.c, reads what comes out, ACKs the display's frames and answers its
+// status requests. The peer streams frames at the display faster than the
+// display can ACK them, so the ring fills and has to push back.
+//
+// Every byte on the wire is parsed independently of ogoa.c: frames must be
+// whole, in order and intact, and the ACKs must be for exactly the frames the
+// display passed on, with the rest accounted for as refused. Exits 1 if not.
+//
+//   ogoa_tx_bench [--seconds S] [--rate HZ] [--baud N] [--fifo N] [--stall P] [--seed N]
+//
+//   --rate HZ    peer frames per second (default 3000)
+//   --baud N     display TX speed, 8N1 (default 115200)
+//   --fifo N     display TX FIFO bytes (default 32)
+//   --stall P    probability a write takes nothing (default 0.1)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+#include "ogoa.h"
+
+#define BENCH_STEP_US 50u
+#define BENCH_PAYLOAD_BYTES 64u
+#define BENCH_STATUS_INTERVAL_MS 250u
+#define BENCH_DRAIN_LIMIT_US 5000000ull
+
+static uint64_t nowUs = 0;
+static uint32_t randomState = 1u;
+
+static uint32_t nextRandom() {
+    randomState = randomState * 1664525u + 1013904223u;
+    return randomState >> 8;
+}
+
+static uint32_t nowMs() {
+    return (uint32_t)(nowUs / 1000u);
+}
+
+// Display TX: takes what the FIFO has room for, or less, or nothing.
+struct ThrottledPipe {
+    uint32_t baud;
+    uint32_t fifo;
+    double stall;
+    uint64_t idleAtNs;
+    std::vector<uint8_t> wire;
+    uint64_t calls;
+    uint64_t shortWrites;
+    uint64_t stalls;
+};
+
+static int pipeTx(void* user, const uint8_t* data, size_t len) {
+    ThrottledPipe* p = static_cast<ThrottledPipe*>(user);
+    p->calls++;
+    uint64_t now = nowUs * 1000u;
+    uint64_t byteNs = 10000000000ull / p->baud;
+    if (p->idleAtNs < now) p->idleAtNs = now;
+    uint64_t queued = (p->idleAtNs - now + byteNs - 1u) / byteNs;
+    size_t room = (queued >= p->fifo) ? 0u : (size_t)(p->fifo - queued);
+    if (room > 0u && (double)(nextRandom() & 0xFFFFu) / 65536.0 < p->stall) {
+        p->stalls++;
+        room = 0u;
+    }
+    if (room > 1u && (nextRandom() & 1u)) room = 1u + nextRandom() % room;
+    size_t n = (len < room) ? len : room;
+    if (n < len) p->shortWrites++;
+    p->wire.insert(p->wire.end(), data, data + n);
+    p->idleAtNs += (uint64_t)n * byteNs;
+    return (int)n;
+}
+
+// ===== DISPLAY =====
+
+struct Display {
+    ogoa_ctx_t ogoa;
+    std::vector<uint8_t> in;        // from the peer, read each step
+    std::vector<uint8_t> ackedSeqs; // frames passed on, so ACK queued
+    bool reading;                   // in ogoa_process_byte, so busy means an ACK
+    uint64_t refusedAcks;
+    uint64_t refusedRetries;
+    uint64_t statusSent;
+    uint64_t statusRefused;
+    uint64_t txFaults;
+};
+
+static Display disp;
+
+// The context's user pointer is the pipe, for pipeTx.
+static void dispOnFrame(void*, const ogoa_frame_t* frame) {
+    disp.ackedSeqs.push_back(frame->seq);
+}
+
+static void dispOnError(void*, ogoa_err_t err) {
+    if (err == OGOA_ERR_TX_BUSY) {
+        if (disp.reading) disp.refusedAcks++;
+        else disp.refusedRetries++;
+    }
+    if (err == OGOA_ERR_TX_FAILED) disp.txFaults++;
+}
+
+// ===== PEER =====
+
+struct Peer {
+    ogoa_ctx_t ogoa;
+    uint8_t seq;
+    uint64_t framesSent;
+    uint64_t statusRx;
+};
+
+static Peer peer;
+
+static int peerTx(void*, const uint8_t* data, size_t len) {
+    disp.in.insert(disp.in.end(), data, data + len);
+    return (int)len;
+}
+
+static void peerSendFrame(uint8_t type, const uint8_t* payload, uint8_t len) {
+    uint8_t frame[OGOA_FRAME_MAX_BYTES];
+    size_t n = ogoa_build_frame_bytes(peer.seq++, type, payload, len, frame);
+    peerTx(nullptr, frame, n);
+    peer.framesSent++;
+}
+
+static void peerOnFrame(void*, const ogoa_frame_t* frame) {
+    if (frame->type == OGOA_TYPE_STATUS_RESPONSE) peer.statusRx++;
+    if (frame->type == OGOA_TYPE_STATUS_REQUEST) {
+        const uint8_t status[3] = { 0u, 128u, 128u };
+        peerSendFrame(OGOA_TYPE_STATUS_RESPONSE, status, sizeof(status));
+    }
+}
+
+// ===== WIRE CHECK =====
+
+// Parses the display's output without ogoa.c.
+struct WireCheck {
+    size_t pos;
+    uint64_t frames;
+    uint64_t acks;
+    uint64_t badBytes;
+    uint64_t badAcks;
+    size_t nextAck;
+};
+
+static void checkWire(const std::vector<uint8_t>& wire, WireCheck* c) {
+    while (c->pos < wire.size()) {
+        if (wire[c->pos] != OGOA_START_BYTE) {
+            c->badBytes++;
+            c->pos++;
+            continue;
+        }
+        if (c->pos + OGOA_HEADER_BYTES > wire.size()) return;
+        size_t total = OGOA_HEADER_BYTES + wire[c->pos + 3] + OGOA_CHECKSUM_BYTES;
+        if (c->pos + total > wire.size()) return;
+        const uint8_t* f = &wire[c->pos];
+        if (ogoa_calc_checksum(f, total - 1u) != f[total - 1u]) {
+            c->badBytes++;
+            c->pos++;
+            continue;
+        }
+        c->frames++;
+        if (f[2] == OGOA_TYPE_ACK) {
+            c->acks++;
+            if (c->nextAck >= disp.ackedSeqs.size() || disp.ackedSeqs[c->nextAck] != f[1]) c->badAcks++;
+            c->nextAck++;
+        }
+        c->pos += total;
+    }
+}
+
+static void usage() {
+    fprintf(stderr, "usage: ogoa_tx_bench [--seconds S] [--rate HZ] [--baud N] [--fifo N] [--stall P] [--seed N]\n");
+}
+
+int main(int argc, char** argv) {
+    double seconds = 10.0;
+    double rate = 3000.0;
+    ThrottledPipe pipe = {};
+    pipe.baud = 115200u;
+    pipe.fifo = 32u;
+    pipe.stall = 0.1;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) {
+            usage();
+            return 2;
+        }
+        if (strcmp(argv[i], "--seconds") == 0) seconds = atof(argv[++i]);
+        else if (strcmp(argv[i], "--rate") == 0) rate = atof(argv[++i]);
+        else if (strcmp(argv[i], "--baud") == 0) pipe.baud = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--fifo") == 0) pipe.fifo = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--stall") == 0) pipe.stall = atof(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0) randomState = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (seconds <= 0.0 || rate <= 0.0 || pipe.baud == 0u || pipe.fifo == 0u || pipe.stall < 0.0 || pipe.stall >= 1.0) {
+        usage();
+        return 2;
+    }
+
+    const ogoa_ops_t dispOps = { pipeTx, dispOnFrame, dispOnError };
+    const ogoa_ops_t peerOps = { peerTx, peerOnFrame, nullptr };
+    ogoa_init(&disp.ogoa, &dispOps, &pipe);
+    ogoa_init(&peer.ogoa, &peerOps, nullptr);
+
+    uint64_t endUs = (uint64_t)(seconds * 1e6);
+    double framePeriodUs = 1e6 / rate;
+    double nextFrameUs = 0.0;
+    uint32_t lastStatusMs = 0u;
+    size_t peerRead = 0u;
+    WireCheck check = {};
+    uint8_t payload[BENCH_PAYLOAD_BYTES];
+
+    for (nowUs = 0u; nowUs < endUs + BENCH_DRAIN_LIMIT_US; nowUs += BENCH_STEP_US) {
+        bool streaming = nowUs < endUs;
+        while (streaming && nextFrameUs <= (double)nowUs) {
+            for (uint8_t& b : payload) b = (uint8_t)nextRandom();
+            peerSendFrame(OGOA_TYPE_LIDAR_SEND, payload, sizeof(payload));
+            nextFrameUs += framePeriodUs;
+        }
+
+        // Display: everything the peer sent, then its own status report.
+        disp.reading = true;
+        for (size_t i = 0; i < disp.in.size(); i++) ogoa_process_byte(&disp.ogoa, disp.in[i], nowMs());
+        disp.reading = false;
+        disp.in.clear();
+        if (streaming && nowMs() - lastStatusMs >= BENCH_STATUS_INTERVAL_MS) {
+            const uint8_t status[3] = { 0u, 1u, 2u };
+            ogoa_err_t err = ogoa_send(&disp.ogoa, OGOA_TYPE_STATUS_RESPONSE, status, sizeof(status), nowMs());
+            if (err == OGOA_OK) {
+                disp.statusSent++;
+                lastStatusMs = nowMs();
+            } else if (err == OGOA_ERR_TX_BUSY) {
+                disp.statusRefused++;
+            }
+        }
+        ogoa_tick(&disp.ogoa, nowMs());
+
+        // Peer: what made it onto the wire.
+        for (; peerRead < pipe.wire.size(); peerRead++) ogoa_process_byte(&peer.ogoa, pipe.wire[peerRead], nowMs());
+        ogoa_tick(&peer.ogoa, nowMs());
+        checkWire(pipe.wire, &check);
+
+        if (!streaming && disp.in.empty() && ogoa_tx_pending(&disp.ogoa) == 0u && !disp.ogoa.tx_waiting_ack &&
+            !disp.ogoa.tx_status_loop) {
+            break;
+        }
+    }
+
+    double lineBytes = (double)pipe.baud / 10.0 * ((double)nowUs / 1e6);
+    bool ok = check.badBytes == 0u && check.badAcks == 0u && check.pos == pipe.wire.size() &&
+              check.acks == disp.ackedSeqs.size() && peer.framesSent == disp.ackedSeqs.size() + disp.refusedAcks &&
+              peer.statusRx == disp.statusSent && ogoa_tx_pending(&disp.ogoa) == 0u && disp.txFaults == 0u;
+
+    printf("%.1f s at %.0f frames/s, %u baud, %u B FIFO, %.0f%% stalls\n", (double)nowUs / 1e6, rate,
+           (unsigned)pipe.baud, (unsigned)pipe.fifo, pipe.stall * 100.0);
+    printf("peer       %llu frames sent, %llu passed on and ACKed, %llu refused (ring full)\n",
+           (unsigned long long)peer.framesSent, (unsigned long long)disp.ackedSeqs.size(),
+           (unsigned long long)disp.refusedAcks);
+    printf("status     %llu sent, %llu tries refused (OGOA_ERR_TX_BUSY), %llu received, %llu retries deferred\n",
+           (unsigned long long)disp.statusSent, (unsigned long long)disp.statusRefused,
+           (unsigned long long)peer.statusRx, (unsigned long long)disp.refusedRetries);
+    printf("transport  %llu writes, %llu short, %llu took nothing; %zu B out (%.0f%% of the line)\n",
+           (unsigned long long)pipe.calls, (unsigned long long)pipe.shortWrites, (unsigned long long)pipe.stalls,
+           pipe.wire.size(), lineBytes > 0.0 ? pipe.wire.size() * 100.0 / lineBytes : 0.0);
+    printf("ring       peak %u of %u B, %lu frames refused\n", (unsigned)disp.ogoa.tx_ring_peak,
+           (unsigned)OGOA_TX_RING_BYTES, (unsigned long)disp.ogoa.stats.tx_busy);
+    printf("wire       %llu frames (%llu ACKs), %llu bad bytes, %llu ACKs out of order\n",
+           (unsigned long long)check.frames, (unsigned long long)check.acks, (unsigned long long)check.badBytes,
+           (unsigned long long)check.badAcks);
+    printf("%s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+// Host benchmark for the proximity engine (lib/Proximity), built by the
+// native_prox_bench env in platformio.ini.
+//
+// Reduces a set of scans into the dashboard's three sectors with ProxEngine
+// and with a plain per-bin branching loop, checks that both agree, and
+// reports the cost per scan of each. On the device the same reduction is
+// timed by the "prox" profiler stage (env rpipico2w_profile).
+//
+//   prox_bench [--scans N] [--rounds N] [--scan FILE]
+//
+// --scan uses raw frames of 360 little-endian uint16 distances (mm), as
+// render_bench does, instead of synthetic scans.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+#include "Proximity.h"
+
+#define BENCH_SCANS 256
+#define BENCH_ROUNDS 2000
+#define BENCH_THRESHOLD_MM 500u
+
+static const ProxSector benchSectors[] = {
+    { 225u, 90u, BENCH_THRESHOLD_MM },
+    { 315u, 90u, BENCH_THRESHOLD_MM },
+    { 45u, 90u, BENCH_THRESHOLD_MM },
+};
+static const uint8_t benchSectorCount = sizeof(benchSectors) / sizeof(benchSectors[0]);
+
+// Noisy walls with uncovered bins, no-returns and the odd close obstacle,
+// so every branch of the reference loop is taken.
+static void synthScan(uint32_t i, uint32_t& rng, uint16_t* out) {
+    for (uint16_t a = 0; a < PROX_BINS; a++) {
+        rng = rng * 1664525u + 1013904223u;
+        uint32_t r = rng >> 8;
+        uint16_t d = (uint16_t)(600u + (a * 7u + i * 13u) % 2800u + r % 40u);
+        if (r % 97u == 0u) d = 0u;
+        if (r % 53u == 0u) d = 4095u;
+        if ((a + i) % 120u < 6u) d = (uint16_t)(150u + r % 300u);
+        out[a] = d;
+    }
+}
+
+static bool loadScans(const char* path, std::vector<uint16_t>& scans) {
+    FILE* fp = fopen(path, "rb");
+    if (fp == nullptr) return false;
+    uint8_t pair[2];
+    while (fread(pair, 1, 2, fp) == 2) {
+        scans.push_back((uint16_t)(pair[0] | (pair[1] << 8)));
+    }
+    fclose(fp);
+    scans.resize(scans.size() - scans.size() % PROX_BINS);
+    return !scans.empty();
+}
+
+// What the engine replaces: one branch per test per bin.
+static void reduceReference(const uint16_t* distances, uint16_t maxRangeMm, ProxReport* out) {
+    out->sectorCount = benchSectorCount;
+    for (uint8_t s = 0; s < benchSectorCount; s++) {
+        const ProxSector& sec = benchSectors[s];
+        ProxSectorResult& res = out->sectors[s];
+        res.minMm = PROX_NONE;
+        res.nearestDeg = PROX_NONE;
+        res.belowCount = 0;
+        for (uint16_t k = 0; k < sec.spanDeg; k++) {
+            uint16_t a = (uint16_t)((sec.startDeg + k) % PROX_BINS);
+            uint16_t d = distances[a];
+            if (d == 0u || d >= maxRangeMm) continue;
+            if (d < sec.thresholdMm) res.belowCount++;
+            if (d < res.minMm) {
+                res.minMm = d;
+                res.nearestDeg = a;
+            }
+        }
+    }
+}
+
+template <typename Fn>
+static double timeScans(const std::vector<uint16_t>& scans, uint32_t rounds, Fn fn, uint32_t& sink) {
+    size_t count = scans.size() / PROX_BINS;
+    ProxReport report;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < count; i++) {
+            fn(&scans[i * PROX_BINS], &report);
+            sink += report.sectors[0].minMm + report.sectors[2].belowCount;
+        }
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    return ns / ((double)rounds * (double)count);
+}
+
+static void usage() {
+    fprintf(stderr, "usage: prox_bench [--scans N] [--rounds N] [--scan FILE]\n");
+}
+
+int main(int argc, char** argv) {
+    uint32_t scanCount = BENCH_SCANS;
+    uint32_t rounds = BENCH_ROUNDS;
+    const char* scanPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--scans") == 0 && hasValue) {
+            scanCount = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--rounds") == 0 && hasValue) {
+            rounds = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--scan") == 0 && hasValue) {
+            scanPath = argv[++i];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    std::vector<uint16_t> scans;
+    if (scanPath != nullptr) {
+        if (!loadScans(scanPath, scans)) {
+            fprintf(stderr, "prox_bench: cannot read scans from %s\n", scanPath);
+            return 1;
+        }
+    } else {
+        uint32_t rng = 1u;
+        scans.resize((size_t)scanCount * PROX_BINS);
+        for (uint32_t i = 0; i < scanCount; i++) synthScan(i, rng, &scans[(size_t)i * PROX_BINS]);
+    }
+    size_t count = scans.size() / PROX_BINS;
+    if (count == 0u || rounds == 0u) {
+        usage();
+        return 2;
+    }
+
+    ProxEngine engine;
+    engine.setSectors(benchSectors, benchSectorCount);
+
+    for (size_t i = 0; i < count; i++) {
+        ProxReport got, want;
+        engine.reduce(&scans[i * PROX_BINS], &got);
+        reduceReference(&scans[i * PROX_BINS], engine.maxRangeMm, &want);
+        if (memcmp(got.sectors, want.sectors, sizeof(ProxSectorResult) * benchSectorCount) != 0) {
+            fprintf(stderr, "prox_bench: scan %zu differs from the reference\n", i);
+            return 1;
+        }
+    }
+
+    uint32_t sink = 0;
+    double engineNs = timeScans(scans, rounds, [&](const uint16_t* d, ProxReport* r) { engine.reduce(d, r); }, sink);
+    double refNs = timeScans(scans, rounds,
+                             [&](const uint16_t* d, ProxReport* r) { reduceReference(d, engine.maxRangeMm, r); }, sink);
+
+    printf("%zu scans x %u rounds, %u sectors, %u bins per scan\n", count, rounds, benchSectorCount,
+           (unsigned)(benchSectors[0].spanDeg + benchSectors[1].spanDeg + benchSectors[2].spanDeg));
+    printf("engine     %8.1f ns/scan\n", engineNs);
+    printf("reference  %8.1f ns/scan  (x%.2f)\n", refNs, engineNs > 0 ? refNs / engineNs : 0.0);
+    printf("checksum   %u\n", sink);
+    return 0;
+}
@@ -0,0 +1,451 @@
+// Host benchmark for the dashboard widgets, built against the headless
+// TFT_eSPI in tools/headless (pio run -e native_bench).
+//
+// Each scenario puts a set of widgets on a 480x320 panel, either each with
+// its own sprite (draw + push) or through the Compositor, and replays a scan
+// sequence into them for a number of frames. It reports time, panel bytes and
+// pixels per frame, then hashes the final panel image and checks it against
+// golden.txt. A mismatch writes the frame as <scenario>.ppm and fails.
+//
+// The host time leaves out the panel transfer, which on the device is most of
+// a frame. "spi us/f" estimates it from the panel bytes at the SPI clock plus
+// BENCH_WINDOW_US for each window, and "full us/f" does the same for pushing
+// every widget's whole sprite once, the own-sprite path without dirty spans.
+//
+// "graph.rate" then feeds one own-sprite LidarGraph many samples per draw,
+// as a fast sensor would, and times addPoint + draw per sample against a
+// full replot of the same samples. Both graphs must end up with the same
+// image.
+//
+//   render_bench [--frames N] [--scan FILE] [--only NAME] [--ppm DIR]
+//                [--golden FILE] [--update] [--spi-mhz N]
+//
+// --scan replays raw frames of 360 little-endian uint16 distances (mm)
+// instead of the built-in synthetic room; golden checks are skipped then.
+// --update rewrites the golden file from this run.
+
+#include <Arduino.h>
+#include <TFT_eSPI.h>
+
+#include <chrono>
+#include <vector>
+
+#include "Compositor.h"
+#include "LidarGraph.h"
+#include "LidarPolar.h"
+#include "ProxBar.h"
+#include "TextPanel.h"
+
+#define BENCH_SCREEN_W 480
+#define BENCH_SCREEN_H 320
+#define BENCH_FRAMES 300
+#define BENCH_SCAN_BINS 360
+#define BENCH_RANGE_MM 4000
+#define BENCH_GOLDEN "tools/render_bench/golden.txt"
+#define BENCH_MAX_SCENARIOS 32
+// TFT_eSPI's own default write clock unless the build sets one.
+#if defined(SPI_FREQUENCY)
+#define BENCH_SPI_HZ SPI_FREQUENCY
+#else
+#define BENCH_SPI_HZ 27000000u
+#endif
+// Per window, beyond its bytes: the D/C switches, each waiting for the SPI
+// FIFO to drain, and the call into the driver.
+#define BENCH_WINDOW_US 1.0
+
+// ================= SCAN SOURCE =================
+
+// Either frames loaded from a file or a synthetic rectangular room with an
+// obstacle walking around it and a little deterministic noise.
+class ScanSource {
+public:
+    bool load(const char* path) {
+        FILE* fp = fopen(path, "rb");
+        if (fp == nullptr) return false;
+
+        uint8_t pair[2];
+        while (fread(pair, 1, 2, fp) == 2) {
+            recorded.push_back((uint16_t)(pair[0] | (pair[1] << 8)));
+        }
+        fclose(fp);
+        recorded.resize(recorded.size() - recorded.size() % BENCH_SCAN_BINS);
+        return !recorded.empty();
+    }
+
+    bool isRecorded() const { return !recorded.empty(); }
+
+    const uint16_t* frame(uint32_t i) {
+        if (isRecorded()) {
+            size_t frames = recorded.size() / BENCH_SCAN_BINS;
+            return &recorded[(i % frames) * BENCH_SCAN_BINS];
+        }
+
+        uint32_t noise = 0x9E3779B9u ^ i;
+        for (uint16_t a = 0; a < BENCH_SCAN_BINS; a++) {
+            float rad = a * (float)(PI / 180.0);
+            float dx = fabsf(sinf(rad)) > 1e-3f ? 1800.0f / fabsf(sinf(rad)) : 1e9f;
+            float dy = fabsf(cosf(rad)) > 1e-3f ? 1200.0f / fabsf(cosf(rad)) : 1e9f;
+            uint32_t d = (uint32_t)((dx < dy) ? dx : dy);
+
+            noise = noise * 1664525u + 1013904223u;
+            d += (noise >> 24) % 31u;
+            d -= 15u;
+
+            uint16_t obstacle = (uint16_t)((i * 3u) % BENCH_SCAN_BINS);
+            if ((uint16_t)((a + BENCH_SCAN_BINS - obstacle) % BENCH_SCAN_BINS) < 12u) {
+                d = 700u + (i * 7u) % 500u;
+            }
+            synthetic[a] = (uint16_t)d;
+        }
+        return synthetic;
+    }
+
+private:
+    std::vector<uint16_t> recorded;
+    uint16_t synthetic[BENCH_SCAN_BINS];
+};
+
+// ================= SCENARIOS =================
+
+enum {
+    W_POLAR = 1u << 0,
+    W_GRAPH = 1u << 1,
+    W_PROX = 1u << 2,
+    W_TEXT = 1u << 3,
+    W_ALL = W_POLAR | W_GRAPH | W_PROX | W_TEXT
+};
+
+struct Scenario {
+    const char* name;
+    uint8_t widgets;
+    bool tiles;       // through the Compositor instead of own sprites
+    uint8_t depth;    // own-sprite colour depth
+};
+
+static const Scenario scenarios[] = {
+    { "polar.sprite16", W_POLAR, false, 16 },
+    { "polar.sprite4", W_POLAR, false, 4 },
+    { "polar.tiles", W_POLAR, true, 16 },
+    { "graph.sprite16", W_GRAPH, false, 16 },
+    { "graph.sprite1", W_GRAPH, false, 1 },
+    { "graph.tiles", W_GRAPH, true, 16 },
+    { "prox.sprite16", W_PROX, false, 16 },
+    { "prox.tiles", W_PROX, true, 16 },
+    { "text.sprite16", W_TEXT, false, 16 },
+    { "text.tiles", W_TEXT, true, 16 },
+    { "dashboard.sprite16", W_ALL, false, 16 },
+    { "dashboard.tiles", W_ALL, true, 16 },
+};
+
+struct Result {
+    uint32_t frames;
+    double usPerFrame;
+    HeadlessStats panel;
+    HeadlessStats sprites;
+    uint32_t fullBytes;     // per frame, pushing every widget's whole sprite
+    uint32_t fullWindows;
+    uint64_t hash;
+};
+
+static double transferUs(double bytes, double windows, uint32_t spiHz) {
+    return bytes * 8.0e6 / spiHz + windows * BENCH_WINDOW_US;
+}
+
+// Same layout as the firmware dashboard, with a graph where the rear radar
+// sits so every widget type is on screen.
+static void runScenario(const Scenario& sc, ScanSource& scans, uint32_t frames, TFT_eSPI& tft, Result& out) {
+    tft.setRotation(1);
+    tft.fillScreen(TFT_BLACK);
+
+    TFT_eSPI* own = sc.tiles ? nullptr : &tft;
+    Compositor compositor(&tft, BENCH_SCREEN_W, BENCH_SCREEN_H, TFT_BLACK);
+    TextPanel* text = nullptr;
+    LidarPolar* polar = nullptr;
+    LidarGraph* graph = nullptr;
+    ProxBar* proxLeft = nullptr;
+    ProxBar* proxRight = nullptr;
+    Widget* widgets[5];
+    uint8_t count = 0;
+
+    if (sc.tiles) compositor.begin();
+    if (sc.widgets & W_TEXT) {
+        text = new TextPanel(own, 0, 0, BENCH_SCREEN_W, 50, TFT_WHITE, TFT_BLACK, sc.depth);
+        text->addLine(2, 2);
+        text->addLine(16, 1);
+        text->addLine(28, 1);
+        text->addLine(40, 1);
+        text->setText(0, "SYSTEM READY");
+        widgets[count++] = text;
+    }
+    if (sc.widgets & W_POLAR) {
+        polar = new LidarPolar(own, 40, 50, 200, 200, TFT_GREEN, BENCH_RANGE_MM, sc.depth);
+        widgets[count++] = polar;
+    }
+    if (sc.widgets & W_GRAPH) {
+        graph = new LidarGraph(own, 260, 50, 200, 200, TFT_CYAN, sc.depth);
+        widgets[count++] = graph;
+    }
+    if (sc.widgets & W_PROX) {
+        proxLeft = new ProxBar(own, 10, 50, 20, 150, sc.depth);
+        proxRight = new ProxBar(own, 470, 50, 20, 150, sc.depth);
+        widgets[count++] = proxLeft;
+        widgets[count++] = proxRight;
+    }
+    if (sc.tiles) {
+        for (uint8_t i = 0; i < count; i++) compositor.add(widgets[i]);
+    }
+
+    tft.resetStats();
+    memset(&headlessSpriteStats, 0, sizeof(headlessSpriteStats));
+
+    double totalUs = 0.0;
+    for (uint32_t f = 0; f < frames; f++) {
+        const uint16_t* scan = scans.frame(f);
+
+        // Feeding the widgets is part of a frame's work too.
+        auto t0 = std::chrono::steady_clock::now();
+        if (polar != nullptr) {
+            for (uint16_t a = 0; a < BENCH_SCAN_BINS; a++) polar->updatePoint(a, scan[a]);
+        }
+        if (graph != nullptr) {
+            graph->addPoint(scan[0] * 100 / BENCH_RANGE_MM);
+            graph->addPoint(scan[90] * 100 / BENCH_RANGE_MM);
+        }
+        if (proxLeft != nullptr) {
+            proxLeft->setValue((int)((f * 3u) % 101u));
+            proxRight->setValue((int)(100u - (f * 2u) % 101u));
+        }
+        if (text != nullptr) {
+            char line[TEXT_PANEL_LINE_CHARS];
+            snprintf(line, sizeof(line), "frame %lu  front %u mm", (unsigned long)f, scan[0]);
+            text->setText(1, line);
+            snprintf(line, sizeof(line), "right %u mm  rear %u mm", scan[90], scan[180]);
+            text->setText(2, line);
+        }
+
+        if (sc.tiles) {
+            compositor.update();
+        } else {
+            for (uint8_t i = 0; i < count; i++) {
+                widgets[i]->draw();
+                widgets[i]->push();
+            }
+        }
+        totalUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    out.frames = frames;
+    out.usPerFrame = frames ? totalUs / frames : 0.0;
+    out.panel = tft.stats;
+    out.sprites = headlessSpriteStats;
+    out.hash = tft.frameHash();
+    out.fullBytes = 0;
+    out.fullWindows = count;
+    for (uint8_t i = 0; i < count; i++) {
+        out.fullBytes += HEADLESS_WINDOW_BYTES + (uint32_t)widgets[i]->w * widgets[i]->h * HEADLESS_PIXEL_BYTES;
+    }
+
+    for (uint8_t i = 0; i < count; i++) delete widgets[i];
+}
+
+// ================= GRAPH SAMPLE RATE =================
+
+struct GraphRate {
+    uint16_t samplesPerDraw;
+    double drawUs;      // per sample: addPoint + the incremental draw()
+    double replotUs;    // per sample: addPoint + render() of the whole plot
+    bool same;
+};
+
+static double feedGraph(LidarGraph& graph, ScanSource& scans, uint32_t frames, uint16_t samplesPerDraw, bool replot) {
+    uint32_t bin = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t f = 0; f < frames; f++) {
+        const uint16_t* scan = scans.frame(f);
+        for (uint16_t i = 0; i < samplesPerDraw; i++) {
+            graph.addPoint(scan[bin] * 100 / BENCH_RANGE_MM);
+            if (++bin == BENCH_SCAN_BINS) bin = 0;
+        }
+        if (replot) {
+            graph.render(graph.sprite, 0, 0);
+        } else {
+            graph.draw();
+        }
+    }
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    return us / ((double)frames * samplesPerDraw);
+}
+
+static void runGraphRate(ScanSource& scans, uint32_t frames, GraphRate& out) {
+    TFT_eSPI drawPanel(BENCH_SCREEN_H, BENCH_SCREEN_W);
+    TFT_eSPI replotPanel(BENCH_SCREEN_H, BENCH_SCREEN_W);
+    drawPanel.setRotation(1);
+    replotPanel.setRotation(1);
+    LidarGraph drawn(&drawPanel, 260, 50, 200, 200, TFT_CYAN);
+    LidarGraph replotted(&replotPanel, 260, 50, 200, 200, TFT_CYAN);
+
+    out.drawUs = feedGraph(drawn, scans, frames, out.samplesPerDraw, false);
+    out.replotUs = feedGraph(replotted, scans, frames, out.samplesPerDraw, true);
+    drawn.push();
+    replotted.push();
+    out.same = drawPanel.frameHash() == replotPanel.frameHash();
+}
+
+// ================= GOLDEN FILE =================
+
+struct Golden {
+    char name[48];
+    uint32_t frames;
+    uint64_t hash;
+};
+
+static size_t loadGolden(const char* path, Golden* out, size_t max) {
+    FILE* fp = fopen(path, "r");
+    if (fp == nullptr) return 0;
+
+    char line[128];
+    size_t n = 0;
+    while (n < max && fgets(line, sizeof(line), fp) != nullptr) {
+        if (line[0] == '#' || line[0] == '\n') continue;
+        unsigned long frames = 0;
+        unsigned long long hash = 0;
+        if (sscanf(line, "%47s %lu %llx", out[n].name, &frames, &hash) == 3) {
+            out[n].frames = (uint32_t)frames;
+            out[n].hash = (uint64_t)hash;
+            n++;
+        }
+    }
+    fclose(fp);
+    return n;
+}
+
+static const Golden* findGolden(const Golden* g, size_t n, const char* name, uint32_t frames) {
+    for (size_t i = 0; i < n; i++) {
+        if (strcmp(g[i].name, name) == 0 && g[i].frames == frames) return &g[i];
+    }
+    return nullptr;
+}
+
+// ================= MAIN =================
+
+static void usage() {
+    fprintf(stderr, "usage: render_bench [--frames N] [--scan FILE] [--only NAME] [--ppm DIR]\n"
+                    "                    [--golden FILE] [--update] [--spi-mhz N]\n");
+}
+
+int main(int argc, char** argv) {
+    uint32_t frames = BENCH_FRAMES;
+    const char* scanPath = nullptr;
+    const char* only = nullptr;
+    const char* ppmDir = nullptr;
+    const char* goldenPath = BENCH_GOLDEN;
+    bool update = false;
+    uint32_t spiHz = BENCH_SPI_HZ;
+
+    for (int i = 1; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--frames") == 0 && hasValue) {
+            frames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--scan") == 0 && hasValue) {
+            scanPath = argv[++i];
+        } else if (strcmp(argv[i], "--only") == 0 && hasValue) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--ppm") == 0 && hasValue) {
+            ppmDir = argv[++i];
+        } else if (strcmp(argv[i], "--golden") == 0 && hasValue) {
+            goldenPath = argv[++i];
+        } else if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--spi-mhz") == 0 && hasValue) {
+            spiHz = (uint32_t)(strtod(argv[++i], nullptr) * 1e6);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+
+    if (spiHz == 0u) {
+        usage();
+        return 2;
+    }
+
+    ScanSource scans;
+    if (scanPath != nullptr && !scans.load(scanPath)) {
+        fprintf(stderr, "render_bench: cannot read scans from %s\n", scanPath);
+        return 2;
+    }
+    bool checkGolden = !scans.isRecorded();
+
+    Golden golden[BENCH_MAX_SCENARIOS];
+    size_t goldenCount = checkGolden ? loadGolden(goldenPath, golden, BENCH_MAX_SCENARIOS) : 0;
+    FILE* goldenOut = nullptr;
+    if (update && checkGolden) {
+        goldenOut = fopen(goldenPath, "w");
+        if (goldenOut == nullptr) {
+            fprintf(stderr, "render_bench: cannot write %s\n", goldenPath);
+            return 2;
+        }
+        fprintf(goldenOut, "# render_bench golden frames: scenario frames fnv1a64\n");
+    }
+
+    printf("SPI at %.1f MHz, %.1f us per window\n", spiHz / 1e6, BENCH_WINDOW_US);
+    printf("%-20s %6s %9s %9s %8s %9s %9s %9s %9s %7s  %-16s %s\n", "scenario", "frames", "us/frame", "bytes/f",
+           "win/f", "spi us/f", "full us/f", "panelpx/f", "sprpx/f", "calls/f", "hash", "golden");
+
+    int failures = 0;
+    for (const Scenario& sc : scenarios) {
+        if (only != nullptr && strcmp(only, sc.name) != 0) continue;
+
+        TFT_eSPI tft(BENCH_SCREEN_H, BENCH_SCREEN_W);
+        Result r;
+        runScenario(sc, scans, frames, tft, r);
+
+        double f = r.frames ? (double)r.frames : 1.0;
+        const char* verdict = "-";
+        if (goldenOut != nullptr) {
+            fprintf(goldenOut, "%s %lu %016llx\n", sc.name, (unsigned long)r.frames, (unsigned long long)r.hash);
+            verdict = "updated";
+        } else if (checkGolden) {
+            const Golden* g = findGolden(golden, goldenCount, sc.name, r.frames);
+            verdict = (g == nullptr) ? "none" : (g->hash == r.hash) ? "ok" : "MISMATCH";
+        }
+
+        printf("%-20s %6lu %9.1f %9.0f %8.1f %9.1f %9.1f %9.0f %9.0f %7.1f  %016llx %s\n", sc.name,
+               (unsigned long)r.frames, r.usPerFrame, r.panel.bytes / f, r.panel.windows / f,
+               transferUs(r.panel.bytes / f, r.panel.windows / f, spiHz),
+               transferUs(r.fullBytes, r.fullWindows, spiHz), r.panel.pixels / f, r.sprites.pixels / f,
+               (r.panel.calls + r.sprites.calls) / f, (unsigned long long)r.hash, verdict);
+
+        bool mismatch = strcmp(verdict, "MISMATCH") == 0;
+        if (mismatch || ppmDir != nullptr) {
+            char path[256];
+            snprintf(path, sizeof(path), "%s/%s.ppm", ppmDir ? ppmDir : ".", sc.name);
+            if (!tft.savePPM(path)) fprintf(stderr, "render_bench: cannot write %s\n", path);
+        }
+        if (mismatch) failures++;
+    }
+
+    if (goldenOut != nullptr) fclose(goldenOut);
+
+    int rateFailures = 0;
+    if (only == nullptr || strcmp(only, "graph.rate") == 0) {
+        // Two samples per draw as in the scenarios, a quarter of the plot
+        // width, and the whole width, where draw() itself falls back to a replot.
+        GraphRate rates[] = { { 2, 0, 0, false }, { 50, 0, 0, false }, { 200, 0, 0, false } };
+        printf("\n%-20s %9s %14s %14s %s\n", "graph.rate", "samples/f", "draw us/smp", "replot us/smp", "image");
+        for (GraphRate& rate : rates) {
+            runGraphRate(scans, frames, rate);
+            printf("%-20s %9u %14.3f %14.3f %s\n", "", rate.samplesPerDraw, rate.drawUs, rate.replotUs,
+                   rate.same ? "same" : "DIFFERENT");
+            if (!rate.same) rateFailures++;
+        }
+    }
+
+    if (failures > 0) {
+        fprintf(stderr, "render_bench: %d scenario(s) differ from %s\n", failures, goldenPath);
+    }
+    if (rateFailures > 0) {
+        fprintf(stderr, "render_bench: the scrolled graph differs from the replotted one\n");
+    }
+    return (failures > 0 || rateFailures > 0) ? 1 : 0;
+}
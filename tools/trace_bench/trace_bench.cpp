@@ -0,0 +1,129 @@
+// Host benchmark for the link's event trace (lib/Trace), built by the
+// native_trace_bench env in platformio.ini.
+//
+// Times what the link core pays per received frame to note the event: a
+// TraceRing record against the snprintf into a string buffer it replaced,
+// for the same mix of events, and what decoding the ring afterwards costs.
+// Also drains the ring through TraceLog, as the debug log does, to a port
+// that takes everything, for the cost per line off the hot path.
+//
+//   trace_bench [--events N]
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+#include "Trace.h"
+#include "TraceLog.h"
+
+#define BENCH_EVENTS 10000000u
+#define BENCH_EVENT_CHARS 64
+
+enum { EV_ACK, EV_STATUS_RESP, EV_SCAN, EV_ERROR, EV_COUNT };
+
+// Mostly scans, as on a running link.
+static uint8_t eventKind(uint32_t i) {
+    uint32_t k = i % 16u;
+    if (k == 0u) return EV_ACK;
+    if (k == 1u) return EV_STATUS_RESP;
+    if (k == 2u) return EV_ERROR;
+    return EV_SCAN;
+}
+
+static int formatEvent(char* out, size_t len, uint8_t kind, uint32_t i) {
+    switch (kind) {
+        case EV_ACK: return snprintf(out, len, "RX ACK seq=%u", (unsigned)(i & 0xFFu));
+        case EV_STATUS_RESP: return snprintf(out, len, "RX STATUS_RESP m=%u x=%u y=%u", 1u, (unsigned)(i & 0xFFu), 128u);
+        case EV_SCAN: return snprintf(out, len, "RX SCAN s=%u pts=%u", (unsigned)(i & 1u), 60u);
+        default: return snprintf(out, len, "OGOA ERR %d", -4);
+    }
+}
+
+static size_t formatRecord(const TraceRecord& rec, char* out, size_t len) {
+    int n = formatEvent(out, len, rec.id, rec.arg0);
+    if (n < 0) return 0u;
+    return ((size_t)n < len) ? (size_t)n : len - 1u;
+}
+
+// Takes everything, like a UART with time to spare.
+class NullPort : public Stream {
+public:
+    int availableForWrite() override { return 256; }
+    size_t write(const uint8_t*, size_t len) override { return len; }
+};
+
+static void usage() {
+    fprintf(stderr, "usage: trace_bench [--events N]\n");
+}
+
+int main(int argc, char** argv) {
+    uint32_t events = BENCH_EVENTS;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--events") == 0 && i + 1 < argc) {
+            events = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (events == 0u) {
+        usage();
+        return 2;
+    }
+
+    static TraceRing ring;
+    static char lastEvent[BENCH_EVENT_CHARS];
+    uint32_t sink = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < events; i++) {
+        uint8_t kind = eventKind(i);
+        ring.record(i, kind, (uint8_t)i, 60u, 128u);
+    }
+    double traceNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / events;
+
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < events; i++) {
+        sink += (uint32_t)formatEvent(lastEvent, sizeof(lastEvent), eventKind(i), i);
+    }
+    double formatNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / events;
+
+    // Reading back: what a dump of the whole ring costs, once.
+    uint32_t kept = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t n = ring.count() - (TRACE_RECORDS - 1u); n != ring.count(); n++) {
+        TraceRecord rec;
+        if (!ring.read(n, &rec)) continue;
+        sink += (uint32_t)formatEvent(lastEvent, sizeof(lastEvent), rec.id, rec.arg0);
+        kept++;
+    }
+    double dumpUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+    // Debug log: one line per record while the writer keeps going.
+    static TraceRing logRing;
+    static TraceLog log(&logRing, formatRecord);
+    static NullPort port;
+    log.begin(&port);
+    uint32_t logEvents = events / 10u;
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < logEvents; i++) {
+        logRing.record(i, eventKind(i), (uint8_t)i, 60u, 128u);
+        log.poll();
+    }
+    double logNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+
+    printf("%u events\n", events);
+    printf("trace      %8.2f ns/event\n", traceNs);
+    printf("snprintf   %8.2f ns/event  (x%.1f)\n", formatNs, traceNs > 0 ? formatNs / traceNs : 0.0);
+    printf("ring       %u records kept, %u B (%u B per record)\n", kept, (unsigned)sizeof(TraceRing),
+           (unsigned)sizeof(TraceRecord));
+    printf("dump       %8.1f us to format all of them\n", dumpUs);
+    printf("log        %8.2f ns/line, %lu lines, %.1f B/line, %lu dropped\n",
+           log.lines > 0u ? logNs / log.lines : 0.0, (unsigned long)log.lines,
+           log.lines > 0u ? (double)log.bytes / log.lines : 0.0, (unsigned long)log.dropped);
+    printf("checksum   %u\n", sink);
+    return 0;
+}